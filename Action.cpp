@@ -2,19 +2,41 @@
 
 Action::Action() {}
 
-Action::Action(const std::string &name, const std::string &type)
-	: m_name(name), m_type(type) {}
+Action::Action(e_Action id, e_Action_Type type)
+	: m_id(id), m_type(type) {}
 
-const std::string &Action::name() const
+Action::Action(e_Action id, e_Action_Type type, std::chrono::steady_clock::time_point time)
+	: m_id(id), m_type(type), m_time(time) {}
+
+e_Action Action::id() const
 {
-	return m_name;
+	return m_id;
 }
-const std::string &Action::type() const
+
+e_Action_Type Action::type() const
 {
 	return m_type;
 }
 
+bool Action::is_start() const
+{
+	return m_type == e_Action_Type::Start;
+}
+
+std::chrono::steady_clock::time_point Action::time() const
+{
+	return m_time;
+}
+
+// names are only needed for debugging output, never for handling an action
 std::string Action::to_string() const
 {
-	return "(" + m_name + ", " + m_type + ")";
+	static const char *names[]=
+	{
+		"NONE", "UP", "DOWN", "PLAY", "QUIT", "PAUSE", "TOGGLE_TEXTURE", "TOGGLE_COLLISION",
+		"TOGGLE_GRID", "REWIND", "RIGHT", "LEFT", "JUMP", "SHOOT"
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == (size_t)e_Action::Count, "every action needs a name");
+
+	return "(" + std::string(names[(size_t)m_id]) + ", " + (is_start() ? "START" : "END") + ")";
 }
\ No newline at end of file
@@ -2,17 +2,47 @@
 
 #include "Common.h"
 
+#include <chrono>
+
+// every action any scene can bind a key to, used to index the scenes' handler tables
+enum class e_Action : uint8_t
+{
+	None,
+	Up,
+	Down,
+	Play,
+	Quit,
+	Pause,
+	Toggle_Texture,
+	Toggle_Collision,
+	Toggle_Grid,
+	Rewind,
+	Right,
+	Left,
+	Jump,
+	Shoot,
+	Count
+};
+
+enum class e_Action_Type : uint8_t { Start, End };
+
+// an action is a couple of small integers and a timestamp, so building one for
+// every key event never allocates and handling one never compares strings
 class Action
 {
-	std::string m_name= "NONE";
-	std::string m_type= "NONE";
+	e_Action								m_id=	e_Action::None;
+	e_Action_Type							m_type= e_Action_Type::Start;
+	std::chrono::steady_clock::time_point	m_time;			// when the input was captured, if it came from one
 
 public:
 
 	Action();
-	Action(const std::string &name, const std::string &type);
+	Action(e_Action id, e_Action_Type type);
+	Action(e_Action id, e_Action_Type type, std::chrono::steady_clock::time_point time);
 
-	const std::string &name() const;
-	const std::string &type() const;
-	std::string to_string() const;
+	e_Action							  id() const;
+	e_Action_Type						  type() const;
+	bool								  is_start() const;
+	std::chrono::steady_clock::time_point time() const;
+	std::string							  to_string() const;
 };
\ No newline at end of file
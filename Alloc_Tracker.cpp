@@ -0,0 +1,124 @@
+#include "Alloc_Tracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	struct system_allocations
+	{
+		const char *name;
+		size_t		count;
+	};
+
+	const size_t MAX_SYSTEMS= 32;
+
+	// every counter is per thread so background work never shows up in a frame
+	thread_local size_t				t_allocations= 0;
+	thread_local size_t				t_frame_start= 0;
+	thread_local system_allocations t_systems[MAX_SYSTEMS];
+	thread_local size_t				t_system_count= 0;
+}
+
+#ifdef _DEBUG
+
+void *operator new(size_t size)
+{
+	t_allocations++;
+
+	if (void *block= std::malloc(size ? size : 1))
+	{
+		return block;
+	}
+	throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	t_allocations++;
+	return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void *block) noexcept					{ std::free(block); }
+void operator delete[](void *block) noexcept				{ std::free(block); }
+void operator delete(void *block, size_t) noexcept			{ std::free(block); }
+void operator delete[](void *block, size_t) noexcept		{ std::free(block); }
+
+#endif
+
+bool Alloc_Tracker::enabled()
+{
+#ifdef _DEBUG
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t Alloc_Tracker::allocations()
+{
+	return t_allocations;
+}
+
+void Alloc_Tracker::begin_frame()
+{
+	t_frame_start= t_allocations;
+
+	for (size_t i= 0; i < t_system_count; i++)
+	{
+		t_systems[i].count= 0;
+	}
+}
+
+size_t Alloc_Tracker::frame_allocations()
+{
+	return t_allocations - t_frame_start;
+}
+
+// prints the frame total followed by every system that allocated this frame
+void Alloc_Tracker::report(std::ostream &out, size_t frame)
+{
+	out << "Frame " << frame << ": " << frame_allocations() << " allocations";
+
+	for (size_t i= 0; i < t_system_count; i++)
+	{
+		if (t_systems[i].count > 0)
+		{
+			out << "  " << t_systems[i].name << "=" << t_systems[i].count;
+		}
+	}
+	out << "\n";
+}
+
+Alloc_Tracker::Scope::Scope(const char *name)
+	: m_name(name), m_start(t_allocations) {}
+
+Alloc_Tracker::Scope::~Scope()
+{
+	size_t count= t_allocations - m_start;
+
+	// systems are identified by their name literal, so a pointer compare is enough
+	for (size_t i= 0; i < t_system_count; i++)
+	{
+		if (t_systems[i].name == m_name)
+		{
+			t_systems[i].count+= count;
+			return;
+		}
+	}
+
+	if (t_system_count < MAX_SYSTEMS)
+	{
+		t_systems[t_system_count++]= { m_name, count };
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+// Counts heap allocations made through the global operator new. The hooks are only
+// compiled into debug builds, in release builds every count stays at zero
+namespace Alloc_Tracker
+{
+	bool	enabled();
+	size_t	allocations();			// allocations made by the calling thread so far
+
+	void	begin_frame();
+	size_t	frame_allocations();	// allocations made by the calling thread since begin_frame()
+	void	report(std::ostream &out, size_t frame);
+
+	// adds the allocations made during its lifetime to the named system for this frame
+	class Scope
+	{
+		const char *m_name;
+		size_t		m_start;
+
+	public:
+
+		Scope(const char *name);
+		~Scope();
+	};
+}
+
+#ifdef _DEBUG
+	#define ALLOC_SCOPE_JOIN(a, b) a##b
+	#define ALLOC_SCOPE_NAME(line) ALLOC_SCOPE_JOIN(alloc_scope_, line)
+	#define ALLOC_SCOPE(name) Alloc_Tracker::Scope ALLOC_SCOPE_NAME(__LINE__)(name)
+#else
+	#define ALLOC_SCOPE(name)
+#endif
@@ -1,51 +1,51 @@
 #include "Animation.h"
 #include <cmath>
+#include <limits>
 
 Animation::Animation()
 {
 }
 
-Animation::Animation(const std::string &name, const sf::Texture &t)
-	: Animation(name, t, 1, 0)
+Animation::Animation(e_Animation id, const sf::Texture &t, size_t frame_count, size_t speed, const sf::IntRect *frames)
+	: m_texture			(&t)
+	, m_frame_count		(frame_count)
+	, m_speed			(speed)
+	, m_frames			(frames)
+	, m_id				(id)
 {
+	m_size= c_Vec2((float)t.getSize().x / frame_count, (float)t.getSize().y);
+}
 
+// restarts playback from the given animation frame
+void Animation::start(size_t frame)
+{
+	m_start_frame= frame;
 }
 
-Animation::Animation(const std::string &name, const sf::Texture &t, size_t frame_count, size_t speed)
-	: m_name			(name)
-	, m_sprite			(t)
-	, m_frame_count		(frame_count)
-	, m_current_frame	(0)
-	, m_speed			(speed)
+size_t Animation::start_frame() const
 {
-	m_size= c_Vec2((float)t.getSize().x / frame_count, (float)t.getSize().y);
-	m_sprite.setOrigin(m_size.x / 2.0f, m_size.y / 2.0f);
-	m_sprite.setTextureRect(sf::IntRect(std::floor(m_current_frame) * m_size.x, 0, m_size.x, m_size.y));
+	return m_start_frame;
 }
 
-// updates the animation to show the next frame, depending on its speed
-// animation loops when it reaches the end
-void Animation::update()
+// the frame of animation showing at the given animation frame, animation loops when it reaches the end
+size_t Animation::frame_index(size_t frame) const
 {
-	m_current_frame++;
+	if (m_speed == 0 || frame < m_start_frame) { return 0; }
 
-	if (m_speed > 0)
-	{
-		size_t frame= (m_current_frame / m_speed) % m_frame_count;
-		sf::IntRect rectangle= sf::IntRect(std::floor(frame) * m_size.x, 0, m_size.x, m_size.y);
-		m_sprite.setTextureRect(rectangle);
-	}
+	return ((frame - m_start_frame) / m_speed) % m_frame_count;
 }
 
-bool Animation::has_ended() const
+// the first animation frame on which a single play through is over, never for still animations
+size_t Animation::end_frame() const
 {
-	bool end= false;
+	if (m_speed == 0) { return std::numeric_limits<size_t>::max(); }
+
+	return m_start_frame + m_speed * m_frame_count;
+}
 
-	if (m_current_frame == (m_speed * m_frame_count) - 1)
-	{
-		end= true;
-	}
-	return end;
+bool Animation::has_ended(size_t frame) const
+{
+	return frame >= end_frame();
 }
 
 const c_Vec2 &Animation::get_size() const
@@ -53,12 +53,27 @@ const c_Vec2 &Animation::get_size() const
 	return m_size;
 }
 
-const std::string &Animation::get_name() const
+size_t Animation::get_speed() const
+{
+	return m_speed;
+}
+
+size_t Animation::get_frame_count() const
+{
+	return m_frame_count;
+}
+
+const sf::IntRect &Animation::get_frame_rect(size_t index) const
+{
+	return m_frames[index];
+}
+
+const sf::Texture *Animation::get_texture() const
 {
-	return m_name;
+	return m_texture;
 }
 
-sf::Sprite &Animation::get_sprite()
+e_Animation Animation::get_id() const
 {
-	return m_sprite;
+	return m_id;
 }
\ No newline at end of file
@@ -1,26 +1,36 @@
 #pragma once
 
 #include "Common.h"
+#include "Asset_IDs.h"
 #include <vector>
 
+// Playback is a pure function of the frame the animation started on and the current
+// animation frame, so nothing has to be advanced per entity. The texture rect is only
+// looked up, from a table built once by Assets, when the scene renders the entity
 class Animation
 {
-	sf::Sprite	m_sprite;
-	size_t		m_frame_count=		1;			// total number of frames of animation
-	size_t		m_current_frame=	0;			// the current frame of animation being played
-	size_t		m_speed=			0;			// the speed to play this animation
-	c_Vec2		m_size=				{ 1,1 };	// the size of the animation frame
-	std::string m_name=				"none";
+	const sf::Texture  *m_texture=			nullptr;
+	size_t				m_frame_count=		1;			// total number of frames of animation
+	size_t				m_speed=			0;			// the speed to play this animation
+	size_t				m_start_frame=		0;			// the animation frame playback started on
+	const sf::IntRect  *m_frames=			nullptr;	// one texture rect per frame, owned by Assets
+	c_Vec2				m_size=				{ 1,1 };	// the size of the animation frame
+	e_Animation			m_id=				e_Animation::Count;
 
 public:
 
 	Animation();
-	Animation(const std::string &name, const sf::Texture &t);
-	Animation(const std::string &name, const sf::Texture &t, size_t frameCount, size_t speed);
+	Animation(e_Animation id, const sf::Texture &t, size_t frameCount, size_t speed, const sf::IntRect *frames);
 
-	void update();
-	bool has_ended() const;
-	const std::string &get_name() const;
+	void start(size_t frame);
+	size_t start_frame() const;
+	size_t frame_index(size_t frame) const;
+	size_t end_frame() const;
+	bool has_ended(size_t frame) const;
+	e_Animation get_id() const;
 	const c_Vec2 &get_size() const;
-	sf::Sprite &get_sprite();
+	size_t get_speed() const;
+	size_t get_frame_count() const;
+	const sf::IntRect &get_frame_rect(size_t index) const;
+	const sf::Texture *get_texture() const;
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Generated from assets.txt by gen_asset_ids.py, do not edit.
+// Every asset gets an id, so a misspelled asset name is a compile error
+// and looking an asset up is an array index
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class e_Texture : uint16_t
+{
+	TexStand,
+	TexRun,
+	TexAir,
+	TexBuster,
+	TexExplode,
+	TexCoin,
+	TexBrick,
+	TexQ,
+	TexQBounce,
+	TexQ2,
+	TexPipeS,
+	TexPipeT,
+	TexCloudB,
+	TexCloudS,
+	TexBush,
+	TexHill,
+	TexGround,
+	TexBlock,
+	TexPole,
+	TexPoleTop,
+	TexFlag,
+	TexGoomba,
+	TexGoomSquash,
+	Count
+};
+
+enum class e_Animation : uint16_t
+{
+	Stand,
+	Run,
+	Air,
+	Buster,
+	Explosion,
+	Coin,
+	Question,
+	Brick,
+	Quest_Bounce,
+	Question2,
+	PipeTall,
+	PipeSmall,
+	CloudBig,
+	CloudSmall,
+	Bush,
+	Hill,
+	Ground,
+	Block,
+	Flag,
+	Pole,
+	PoleTop,
+	Goomba,
+	GoombaSquash,
+	Count
+};
+
+enum class e_Atlas : uint16_t
+{
+	Particles,
+	Count
+};
+
+enum class e_Font : uint16_t
+{
+	Arial,
+	Mario,
+	Megaman,
+	Count
+};
+
+enum class e_Sound : uint16_t
+{
+	Jump,
+	Shoot,
+	Bump,
+	Brick,
+	Coin,
+	Stomp,
+	Kill,
+	Die,
+	Flag,
+	Count
+};
+
+namespace Asset_IDs
+{
+	inline constexpr const char *TEXTURE_NAMES[(size_t)e_Texture::Count + 1]= { "TexStand", "TexRun", "TexAir", "TexBuster", "TexExplode", "TexCoin", "TexBrick", "TexQ", "TexQBounce", "TexQ2", "TexPipeS", "TexPipeT", "TexCloudB", "TexCloudS", "TexBush", "TexHill", "TexGround", "TexBlock", "TexPole", "TexPoleTop", "TexFlag", "TexGoomba", "TexGoomSquash", nullptr };
+	inline constexpr const char *ANIMATION_NAMES[(size_t)e_Animation::Count + 1]= { "Stand", "Run", "Air", "Buster", "Explosion", "Coin", "Question", "Brick", "Quest_Bounce", "Question2", "PipeTall", "PipeSmall", "CloudBig", "CloudSmall", "Bush", "Hill", "Ground", "Block", "Flag", "Pole", "PoleTop", "Goomba", "GoombaSquash", nullptr };
+	inline constexpr const char *ATLAS_NAMES[(size_t)e_Atlas::Count + 1]= { "Particles", nullptr };
+	inline constexpr const char *FONT_NAMES[(size_t)e_Font::Count + 1]= { "Arial", "Mario", "Megaman", nullptr };
+	inline constexpr const char *SOUND_NAMES[(size_t)e_Sound::Count + 1]= { "Jump", "Shoot", "Bump", "Brick", "Coin", "Stomp", "Kill", "Die", "Flag", nullptr };
+}
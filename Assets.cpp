@@ -1,11 +1,63 @@
 #include "Assets.h"
+#include "Trace.h"
 #include <cassert>
 
+namespace
+{
+	// a linear scan, only ever done while reading assets.txt or a level file
+	template <typename T, size_t N>
+	T find_id(const char *const (&names)[N], const std::string &name)
+	{
+		for (size_t i= 0; i + 1 < N; i++)
+		{
+			if (name == names[i]) { return (T)i; }
+		}
+		return T::Count;
+	}
+
+	// an asset that is missing from Asset_IDs.h was added to assets.txt without regenerating it
+	template <typename T>
+	bool known(T id, const char *type, const std::string &name)
+	{
+		if (id == T::Count)
+		{
+			std::cerr << "Unknown " << type << " " << name << ", run gen_asset_ids.py" << std::endl;
+			return false;
+		}
+		return true;
+	}
+}
+
 Assets::Assets()
 {
 
 }
 
+e_Texture Assets::texture_id(const std::string &name)
+{
+	return find_id<e_Texture>(Asset_IDs::TEXTURE_NAMES, name);
+}
+
+e_Animation Assets::animation_id(const std::string &name)
+{
+	return find_id<e_Animation>(Asset_IDs::ANIMATION_NAMES, name);
+}
+
+e_Atlas Assets::atlas_id(const std::string &name)
+{
+	return find_id<e_Atlas>(Asset_IDs::ATLAS_NAMES, name);
+}
+
+e_Font Assets::font_id(const std::string &name)
+{
+	return find_id<e_Font>(Asset_IDs::FONT_NAMES, name);
+}
+
+e_Sound Assets::sound_id(const std::string &name)
+{
+	return find_id<e_Sound>(Asset_IDs::SOUND_NAMES, name);
+}
+
 void Assets::load_from_file(const std::string &path)
 {
 	std::ifstream file(path);
@@ -18,20 +70,58 @@ void Assets::load_from_file(const std::string &path)
 		{
 			std::string name, path;
 			file >> name >> path;
-			add_texture(name, path);
+
+			e_Texture texture= texture_id(name);
+			if (known(texture, "texture", name)) { add_texture(texture, path); }
 		}
 		else if (string == "Animation")
 		{
-			std::string name, texture;
+			std::string name, texture_name;
 			size_t frames, speed;
-			file >> name >> texture >> frames >> speed;
-			add_animation(name, texture, frames, speed);
+			file >> name >> texture_name >> frames >> speed;
+
+			e_Animation animation= animation_id(name);
+			e_Texture texture= texture_id(texture_name);
+			if (known(animation, "animation", name) && known(texture, "texture", texture_name))
+			{
+				add_animation(animation, texture, frames, speed);
+			}
+		}
+		else if (string == "Atlas")
+		{
+			std::string name;
+			size_t count;
+			file >> name >> count;
+
+			std::vector<e_Animation> animations;
+			for (size_t i= 0; i < count; i++)
+			{
+				file >> string;
+
+				e_Animation animation= animation_id(string);
+				if (known(animation, "animation", string)) { animations.push_back(animation); }
+			}
+
+			e_Atlas atlas= atlas_id(name);
+			if (known(atlas, "atlas", name)) { add_atlas(atlas, animations); }
 		}
 		else if (string == "Font")
 		{
 			std::string name, path;
 			file >> name >> path;
-			add_font(name, path);
+
+			e_Font font= font_id(name);
+			if (known(font, "font", name)) { add_font(font, path); }
+		}
+		else if (string == "Sound")
+		{
+			std::string name, path;
+			int priority;
+			float volume;
+			file >> name >> path >> priority >> volume;
+
+			e_Sound sound= sound_id(name);
+			if (known(sound, "sound", name)) { add_sound(sound, path, priority, volume); }
 		}
 		else
 		{
@@ -40,52 +130,134 @@ void Assets::load_from_file(const std::string &path)
 	}
 }
 
-void Assets::add_texture(const std::string &texture_name, const std::string &path, bool smooth)
+void Assets::add_texture(e_Texture id, const std::string &path, bool smooth)
 {
-	m_texture_map[texture_name] = sf::Texture();
+	TRACE_SCOPE("add_texture");
+
+	sf::Texture &texture= m_textures[(size_t)id];
 
-	if (!m_texture_map[texture_name].loadFromFile(path))
+	if (!texture.loadFromFile(path))
 	{
 		std::cerr << "Could not load texture file: " << path << std::endl;
 	}
 	else
 	{
-		m_texture_map[texture_name].setSmooth(smooth);
+		texture.setSmooth(smooth);
 		std::cout << "Loaded Texture: " << path << std::endl;
 	}
 }
 
-const sf::Texture &Assets::get_texture(const std::string &texture_name) const
+const sf::Texture &Assets::get_texture(e_Texture texture) const
 {
-	assert(m_texture_map.find(texture_name) != m_texture_map.end());
-	return m_texture_map.at(texture_name);
+	assert(texture < e_Texture::Count);
+	return m_textures[(size_t)texture];
 }
 
-void Assets::add_animation(const std::string &animation_name, const std::string &texture_name, size_t frame_count, size_t speed)
+void Assets::add_animation(e_Animation id, e_Texture texture, size_t frame_count, size_t speed)
 {
-	m_animation_map[animation_name]= Animation(animation_name, get_texture(texture_name), frame_count, speed);
+	const sf::Texture &sheet= get_texture(texture);
+	int width= sheet.getSize().x / frame_count;
+	int height= sheet.getSize().y;
+
+	auto &frames= m_frame_rects[(size_t)id];
+	frames.clear();
+	for (size_t i= 0; i < frame_count; i++)
+	{
+		frames.push_back(sf::IntRect(i * width, 0, width, height));
+	}
+
+	m_animations[(size_t)id]= Animation(id, sheet, frame_count, speed, frames.data());
 }
 
-const Animation &Assets::get_animation(const std::string &animation_name) const
+const Animation &Assets::get_animation(e_Animation animation) const
 {
-	assert(m_animation_map.find(animation_name) != m_animation_map.end());
-	return m_animation_map.at(animation_name);
+	assert(animation < e_Animation::Count);
+	return m_animations[(size_t)animation];
 }
 
-void Assets::add_font(const std::string &font_name, const std::string &path)
+void Assets::add_font(e_Font id, const std::string &path)
 {
-	sf::Font font;
-	if (!font.loadFromFile(path))
+	if (!m_fonts[(size_t)id].loadFromFile(path))
 	{
 		std::cerr << "Could not load font: " + path + "\n";
 		exit(-1);
 	}
+}
+
+const sf::Font &Assets::get_font(e_Font font) const
+{
+	assert(font < e_Font::Count);
+	return m_fonts[(size_t)font];
+}
 
-	m_font_map[font_name]= font;
+// decodes the whole file now, so playing it never touches the disk
+void Assets::add_sound(e_Sound id, const std::string &path, int priority, float volume)
+{
+	TRACE_SCOPE("add_sound");
+
+	Sound_Effect &sound= m_sounds[(size_t)id];
+	sound.priority= priority;
+	sound.volume= volume;
+
+	if (!sound.buffer.loadFromFile(path))
+	{
+		std::cerr << "Could not load sound file: " << path << std::endl;
+	}
+	else
+	{
+		std::cout << "Loaded Sound: " << path << std::endl;
+	}
+}
+
+const Sound_Effect &Assets::get_sound(e_Sound sound) const
+{
+	assert(sound < e_Sound::Count);
+	return m_sounds[(size_t)sound];
+}
+
+// stacks the textures of the given animations on top of each other in one texture,
+// the animations have to be loaded first
+void Assets::add_atlas(e_Atlas id, const std::vector<e_Animation> &animations)
+{
+	Texture_Atlas &atlas= m_atlases[(size_t)id];
+
+	unsigned width= 0;
+	unsigned height= 0;
+	for (e_Animation part : animations)
+	{
+		const sf::Texture &texture= *get_animation(part).get_texture();
+		width= std::max(width, texture.getSize().x);
+		height+= texture.getSize().y;
+	}
+
+	sf::Image image;
+	image.create(width, height, sf::Color(0, 0, 0, 0));
+
+	unsigned top= 0;
+	for (e_Animation part : animations)
+	{
+		const Animation &animation= get_animation(part);
+		const sf::Texture &texture= *animation.get_texture();
+		image.copy(texture.copyToImage(), 0, top);
+
+		auto &frames= atlas.frames[(size_t)part];
+		for (size_t i= 0; i < animation.get_frame_count(); i++)
+		{
+			sf::IntRect rect= animation.get_frame_rect(i);
+			rect.top+= top;
+			frames.push_back(rect);
+		}
+		top+= texture.getSize().y;
+	}
+
+	if (!atlas.texture.loadFromImage(image))
+	{
+		std::cerr << "Could not build texture atlas: " << Asset_IDs::ATLAS_NAMES[(size_t)id] << std::endl;
+	}
 }
 
-const sf::Font &Assets::get_font(const std::string &font_name) const
+const Texture_Atlas &Assets::get_atlas(e_Atlas atlas) const
 {
-	assert(m_font_map.find(font_name) != m_font_map.end());
-	return m_font_map.at(font_name);
+	assert(atlas < e_Atlas::Count);
+	return m_atlases[(size_t)atlas];
 }
\ No newline at end of file
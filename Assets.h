@@ -2,16 +2,45 @@
 
 #include "Common.h"
 #include "Animation.h"
+#include "Asset_IDs.h"
 
+#include <array>
+
+// several animations packed into one texture so they can all be drawn in a single call
+struct Texture_Atlas
+{
+	sf::Texture																texture;
+	std::array<std::vector<sf::IntRect>, (size_t)e_Animation::Count>		frames;		// every frame of every packed animation, in atlas pixels
+};
+
+// a decoded sound and how the mixer treats it, a higher priority sound can take the
+// voice of a lower one
+struct Sound_Effect
+{
+	sf::SoundBuffer buffer;
+	int				priority= 0;
+	float			volume=	  100;
+};
+
+// Assets are stored in flat arrays indexed by the ids generated from assets.txt into
+// Asset_IDs.h, names are only looked up while reading data files
 class Assets
 {
-	std::map<std::string, sf::Texture>	m_texture_map;
-	std::map<std::string, Animation>	m_animation_map;
-	std::map<std::string, sf::Font>		m_font_map;
+	std::array<sf::Texture, (size_t)e_Texture::Count>		m_textures;
+	std::array<Animation, (size_t)e_Animation::Count>		m_animations;
+	std::array<sf::Font, (size_t)e_Font::Count>				m_fonts;
+	std::array<Texture_Atlas, (size_t)e_Atlas::Count>		m_atlases;
+	std::array<Sound_Effect, (size_t)e_Sound::Count>		m_sounds;
+
+	// texture rects of every frame of every animation, computed once so playing an
+	// animation is a table lookup. Animations point into these vectors
+	std::array<std::vector<sf::IntRect>, (size_t)e_Animation::Count> m_frame_rects;
 
-	void add_texture(const std::string &texture_name, const std::string &path, bool smooth= true);
-	void add_animation(const std::string &animation_Name, const std::string &texture_name, size_t frameCount, size_t speed);
-	void add_font(const std::string &font_name, const std::string &path);
+	void add_texture(e_Texture id, const std::string &path, bool smooth= true);
+	void add_animation(e_Animation id, e_Texture texture, size_t frameCount, size_t speed);
+	void add_font(e_Font id, const std::string &path);
+	void add_atlas(e_Atlas id, const std::vector<e_Animation> &animations);
+	void add_sound(e_Sound id, const std::string &path, int priority, float volume);
 
 public:
 
@@ -19,7 +48,16 @@ public:
 
 	void load_from_file(const std::string &path);
 
-	const sf::Texture	&get_texture(const std::string &texture_name) const;
-	const Animation		&get_animation(const std::string &animation_name) const;
-	const sf::Font		&get_font(const std::string &font_name) const;
+	const sf::Texture	&get_texture(e_Texture texture) const;
+	const Animation		&get_animation(e_Animation animation) const;
+	const sf::Font		&get_font(e_Font font) const;
+	const Texture_Atlas &get_atlas(e_Atlas atlas) const;
+	const Sound_Effect	&get_sound(e_Sound sound) const;
+
+	// the id with this name, or Count when there is none
+	static e_Texture	texture_id(const std::string &name);
+	static e_Animation	animation_id(const std::string &name);
+	static e_Atlas		atlas_id(const std::string &name);
+	static e_Font		font_id(const std::string &name);
+	static e_Sound		sound_id(const std::string &name);
 };
\ No newline at end of file
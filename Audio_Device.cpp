@@ -0,0 +1,86 @@
+#include "Audio_Device.h"
+#include "Trace.h"
+
+#include <numeric>
+
+SFML_Audio_Device::SFML_Audio_Device(size_t voices)
+	: m_sounds(voices)
+{
+	m_running= true;
+	m_thread= std::thread(&SFML_Audio_Device::run, this);
+}
+
+SFML_Audio_Device::~SFML_Audio_Device()
+{
+	m_running= false;
+
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+void SFML_Audio_Device::run()
+{
+	Trace::name_thread("audio");
+
+	auto next= std::chrono::steady_clock::now();
+	play_command command;
+
+	while (m_running)
+	{
+		while (m_queue.pop(command))
+		{
+			sf::Sound &sound= m_sounds[command.voice];
+			sound.stop();
+
+			// a voice that plays the same sound again keeps its buffer bound
+			if (sound.getBuffer() != command.buffer)
+			{
+				sound.setBuffer(*command.buffer);
+			}
+			sound.setVolume(command.volume);
+			sound.setPitch(command.pitch);
+			sound.play();
+		}
+
+		// sf::sleep for the same timer resolution the input capture thread gets
+		next= std::max(next + m_period, std::chrono::steady_clock::now());
+		sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(next - std::chrono::steady_clock::now()).count()));
+	}
+}
+
+size_t SFML_Audio_Device::voices() const
+{
+	return m_sounds.size();
+}
+
+// a full queue drops the sound, which only happens if the audio thread stalls
+void SFML_Audio_Device::play(size_t voice, const sf::SoundBuffer &buffer, float volume, float pitch)
+{
+	m_queue.push({ voice, &buffer, volume, pitch });
+}
+
+Null_Audio_Device::Null_Audio_Device(size_t voices)
+	: m_voices(voices)
+	, m_plays(voices) {}
+
+size_t Null_Audio_Device::voices() const
+{
+	return m_voices;
+}
+
+void Null_Audio_Device::play(size_t voice, const sf::SoundBuffer &, float, float)
+{
+	m_plays[voice]++;
+}
+
+size_t Null_Audio_Device::plays(size_t voice) const
+{
+	return m_plays[voice];
+}
+
+size_t Null_Audio_Device::plays() const
+{
+	return std::accumulate(m_plays.begin(), m_plays.end(), size_t(0));
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Common.h"
+#include "Spsc_Queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Where the mixer's voices end up. A device has a fixed number of voices, each
+// playing one sound at a time, and the mixer decides which voice plays what, so
+// a device only starts sounds and never has to report back
+class Audio_Device
+{
+public:
+
+	virtual ~Audio_Device()= default;
+
+	virtual size_t voices() const= 0;
+
+	// starts the buffer on the voice, cutting off whatever it was playing
+	virtual void play(size_t voice, const sf::SoundBuffer &buffer, float volume, float pitch)= 0;
+};
+
+// Plays through SFML on its own thread. Binding a buffer to an sf::Sound allocates
+// inside SFML, so the game thread only queues the play and the audio thread, which
+// owns every sf::Sound, does the rest about once a millisecond
+class SFML_Audio_Device : public Audio_Device
+{
+	struct play_command
+	{
+		size_t					voice= 0;
+		const sf::SoundBuffer  *buffer= nullptr;
+		float					volume= 100;
+		float					pitch=	1;
+	};
+
+	std::vector<sf::Sound>			m_sounds;
+	Spsc_Queue<play_command, 256>	m_queue;
+	std::thread						m_thread;
+	std::atomic<bool>				m_running{ false };
+	std::chrono::microseconds		m_period{ 1000 };
+
+	void run();
+
+public:
+
+	SFML_Audio_Device(size_t voices);
+	~SFML_Audio_Device();
+
+	size_t voices() const override;
+	void   play(size_t voice, const sf::SoundBuffer &buffer, float volume, float pitch) override;
+};
+
+// Plays nothing and counts what it was asked to play, so the mixer can be driven
+// and benchmarked headless
+class Null_Audio_Device : public Audio_Device
+{
+	size_t				m_voices= 0;
+	std::vector<size_t> m_plays;		// per voice
+
+public:
+
+	Null_Audio_Device(size_t voices);
+
+	size_t voices() const override;
+	void   play(size_t voice, const sf::SoundBuffer &buffer, float volume, float pitch) override;
+
+	size_t plays(size_t voice) const;
+	size_t plays() const;
+};
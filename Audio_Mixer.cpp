@@ -0,0 +1,111 @@
+#include "Audio_Mixer.h"
+#include "Assets.h"
+
+#include <cmath>
+
+audio_stats &audio_stats::operator+=(const audio_stats &other)
+{
+	played+=  other.played;
+	stolen+=  other.stolen;
+	merged+=  other.merged;
+	dropped+= other.dropped;
+	return *this;
+}
+
+Audio_Mixer::Audio_Mixer(const Assets &assets, std::unique_ptr<Audio_Device> device)
+	: m_assets(assets)
+	, m_device(std::move(device))
+	, m_voices(m_device->voices()) {}
+
+void Audio_Mixer::play(e_Sound sound, float pitch)
+{
+	const Sound_Effect &effect= m_assets.get_sound(sound);
+
+	// a sound that failed to load has no length and is never played
+	uint64_t frames= (uint64_t)std::ceil(effect.buffer.getDuration().asSeconds() * m_frame_rate / pitch);
+	if (frames == 0)
+	{
+		m_stats.dropped++;
+		return;
+	}
+
+	size_t free= m_voices.size();
+	size_t victim= m_voices.size();
+
+	for (size_t i= 0; i < m_voices.size(); i++)
+	{
+		const voice &v= m_voices[i];
+
+		if (v.end <= m_frame)
+		{
+			if (free == m_voices.size()) { free= i; }
+			continue;
+		}
+
+		// a burst of the same event, like a volley hitting a row of bricks, plays once
+		if (v.sound == sound && v.start == m_frame)
+		{
+			m_stats.merged++;
+			return;
+		}
+
+		if (victim == m_voices.size()
+			|| v.priority < m_voices[victim].priority
+			|| (v.priority == m_voices[victim].priority && v.start < m_voices[victim].start))
+		{
+			victim= i;
+		}
+	}
+
+	size_t chosen= free;
+	if (chosen == m_voices.size())
+	{
+		if (victim == m_voices.size() || m_voices[victim].priority > effect.priority)
+		{
+			m_stats.dropped++;
+			return;
+		}
+
+		chosen= victim;
+		m_stats.stolen++;
+	}
+
+	m_voices[chosen]= { sound, effect.priority, m_frame, m_frame + frames };
+	m_device->play(chosen, effect.buffer, effect.volume, pitch);
+	m_stats.played++;
+}
+
+void Audio_Mixer::advance()
+{
+	m_frame++;
+}
+
+void Audio_Mixer::set_frame_rate(unsigned rate)
+{
+	m_frame_rate= rate;
+}
+
+size_t Audio_Mixer::voices() const
+{
+	return m_voices.size();
+}
+
+size_t Audio_Mixer::playing() const
+{
+	size_t count= 0;
+	for (const voice &v : m_voices)
+	{
+		count+= v.end > m_frame;
+	}
+	return count;
+}
+
+const audio_stats &Audio_Mixer::stats() const
+{
+	return m_stats;
+}
+
+Audio_Device &Audio_Mixer::device()
+{
+	return *m_device;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Common.h"
+#include "Asset_IDs.h"
+#include "Audio_Device.h"
+
+#include <cstdint>
+
+class Assets;
+
+// what became of the sounds asked for
+struct audio_stats
+{
+	size_t played=	0;
+	size_t stolen=	0;		// played on a voice taken from a sound still playing
+	size_t merged=	0;		// already started on the same frame, played once
+	size_t dropped= 0;		// every voice was busy with a higher priority sound
+
+	audio_stats &operator+=(const audio_stats &other);
+};
+
+// Hands sound effects to a fixed pool of device voices. Each voice remembers what it
+// plays and the frame that ends on, worked out from the decoded length, so finding a
+// voice is a scan of a few entries and never asks the device. With every voice busy
+// the new sound takes the voice of the lowest priority sound, the oldest of those,
+// as long as that is not higher than its own. Nothing allocates once constructed
+class Audio_Mixer
+{
+	struct voice
+	{
+		e_Sound		sound=	  e_Sound::Count;
+		int			priority= 0;
+		uint64_t	start=	  0;		// frame it started on
+		uint64_t	end=	  0;		// first frame it is silent on
+	};
+
+	const Assets				   &m_assets;
+	std::unique_ptr<Audio_Device>	m_device;
+	std::vector<voice>				m_voices;
+	uint64_t						m_frame= 0;
+	unsigned						m_frame_rate= 60;
+	audio_stats						m_stats;
+
+public:
+
+	Audio_Mixer(const Assets &assets, std::unique_ptr<Audio_Device> device);
+
+	void play(e_Sound sound, float pitch= 1);
+	void advance();							// once per displayed frame
+	void set_frame_rate(unsigned rate);
+
+	size_t				voices() const;
+	size_t				playing() const;	// voices still sounding
+	const audio_stats  &stats() const;
+	Audio_Device	   &device();
+};
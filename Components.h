@@ -4,6 +4,8 @@
 #include "Animation.h"
 #include "Assets.h"
 
+#include <cstdint>
+
 class Component
 {
 public:
@@ -68,8 +70,8 @@ public:
 	bool repeat= false;
 	
 	c_Animation() {}
-	c_Animation(const Animation &animation, bool r)
-		: animation(animation), repeat(r) {}
+	c_Animation(const Animation &a, bool r, size_t start_frame)
+		: animation(a), repeat(r) { animation.start(start_frame); }
 };
 
 class c_Gravity : public Component
@@ -81,12 +83,32 @@ public:
 	c_Gravity(float g) : gravity(g) {}
 };
 
+enum class e_State : uint8_t { Standing, Ground, Air, Bouncing };
+
 class c_State : public Component
 {
 public:
-	std::string state= "jumping";
+	e_State state= e_State::Air;
 	
 	c_State() {}
-	c_State(const std::string &s) : state(s) {}
+	c_State(e_State s) : state(s) {}
 };
 
+class c_Pathing : public Component
+{
+public:
+	int target= -1;		// navigation cell the enemy is heading for, -1 when it has no plan
+
+	c_Pathing() {}
+	c_Pathing(int t) : target(t) {}
+};
+
+class c_Streamed : public Component
+{
+public:
+	size_t record= 0;	// index of the level record this entity was spawned from
+	int    chunk=  0;	// the horizontal chunk that record belongs to
+
+	c_Streamed() {}
+	c_Streamed(size_t r, int c) : record(r), chunk(c) {}
+};
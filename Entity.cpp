@@ -1,13 +1,24 @@
 #include "Entity.h"
+#include "Entity_Manager.h"
+#include "Prefab.h"
 
 Entity::Entity(const size_t &id, const enum e_Tag &t)
 	: m_id(id), m_tag(t) {}
 
+// copies the prefab's components straight in rather than building defaults to overwrite
+Entity::Entity(const size_t &id, const Prefab &prefab)
+	: m_asleep(prefab.asleep), m_tag(prefab.tag), m_id(id), m_signature(prefab.signature), m_components(prefab.components) {}
+
 bool Entity::is_active() const
 {
 	return m_active;
 }
 
+bool Entity::is_asleep() const
+{
+	return m_asleep;
+}
+
 void Entity::destroy()
 {
 	m_active= false;
@@ -22,3 +33,15 @@ const e_Tag &Entity::tag() const
 {
 	return m_tag;
 }
+
+
+uint32_t Entity::signature() const
+{
+	return m_signature;
+}
+
+// an entity that is already being queried moved in or out of some views
+void Entity::signature_changed()
+{
+	if (m_manager) { m_manager->invalidate_views(); }
+}
\ No newline at end of file
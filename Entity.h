@@ -5,6 +5,8 @@
 #include "Components.h"
 
 class Entity_Manager;
+struct Prefab;
+template <typename T> class Pool_Allocator;
 
 typedef std::tuple<
 	c_Transform,
@@ -13,35 +15,66 @@ typedef std::tuple<
 	c_Bounding_box,
 	c_Animation,
 	c_Gravity,
-	c_State
+	c_State,
+	c_Streamed,
+	c_Pathing
 > ComponentTuple;
 
 enum class e_Tag{Default, Player, Enemy, Bullet, Tile, Dec};
 
-class Entity
+// A signature has one bit per component type, the type's index in ComponentTuple
+template <typename T, typename Tuple> struct component_index;
+
+template <typename T, typename... Ts>
+struct component_index<T, std::tuple<T, Ts...>> { static constexpr size_t value= 0; };
+
+template <typename T, typename U, typename... Ts>
+struct component_index<T, std::tuple<U, Ts...>> { static constexpr size_t value= 1 + component_index<T, std::tuple<Ts...>>::value; };
+
+static_assert(std::tuple_size<ComponentTuple>::value <= 32, "a signature has room for 32 component types");
+
+template <typename... Ts>
+constexpr uint32_t signature_of()
+{
+	return (0u | ... | (1u << component_index<Ts, ComponentTuple>::value));
+}
+
+// shared_from_this lets code holding only a reference, such as an event handler, hand
+// the entity to a timer that keeps it alive
+class Entity : public std::enable_shared_from_this<Entity>
 {
 	friend class Entity_Manager;
+	template <typename T> friend class Pool_Allocator;
 
 	bool			m_active= true;
+	bool			m_asleep= false;
 	e_Tag			m_tag= e_Tag::Default;
 	size_t			m_id= 0;
+	uint32_t		m_signature= 0;			// the components this entity has
+	Entity_Manager *m_manager= nullptr;		// set once the entity is in the manager's vectors
 	ComponentTuple	m_components;
 
 	// constructor is private so we can never create
 	// entities outside the Entity_Manager which had friend access
+	// (the Entity_Manager builds them through its Pool_Allocator)
 	Entity(const size_t &id, const enum e_Tag &tag);
+	Entity(const size_t &id, const Prefab &prefab);
+
+	void signature_changed();
 
 public:
 
 	void		destroy();
 	size_t		id()		const;
 	bool		is_active() const;
+	bool		is_asleep() const;
 	const e_Tag &tag()		const;
+	uint32_t	signature() const;
 
 	template <typename T>
 	bool has_component() const
 	{
-		return get_component<T>().has;
+		return (m_signature & signature_of<T>()) != 0;
 	}
 
 	template <typename T, typename... T_args>
@@ -50,6 +83,12 @@ public:
 		auto &component= get_component<T>();
 		component= T(std::forward<T_args>(m_args)...);
 		component.has= true;
+
+		if (!has_component<T>())
+		{
+			m_signature|= signature_of<T>();
+			signature_changed();
+		}
 		return component;
 	}
 
@@ -70,5 +109,11 @@ public:
 	{
 		auto &component= get_component<T>();
 		component.has= false;
+
+		if (has_component<T>())
+		{
+			m_signature&= ~signature_of<T>();
+			signature_changed();
+		}
 	}
 };
\ No newline at end of file
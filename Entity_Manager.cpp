@@ -1,7 +1,38 @@
 #include "Entity_Manager.h"
 
-Entity_Manager::Entity_Manager() {}
-	
+static const e_Tag ALL_TAGS[]= { e_Tag::Default, e_Tag::Player, e_Tag::Enemy, e_Tag::Bullet, e_Tag::Tile, e_Tag::Dec };
+
+Entity_Manager::Entity_Manager(std::pmr::memory_resource *resource)
+	: m_resource(resource)
+	, m_entities(resource)
+	, m_entities_to_add(resource)
+	, m_entity_map(resource)
+	, m_awake_entities(resource)
+	, m_awake_map(resource)
+	, m_views(resource)
+{
+	// reserve up front so the vectors reach their high water mark while loading
+	// instead of growing during gameplay
+	m_entities.reserve(1024);
+	m_entities_to_add.reserve(256);
+	m_awake_entities.reserve(256);
+
+	for (e_Tag tag : ALL_TAGS)
+	{
+		m_entity_map[tag].reserve(64);
+		m_awake_map[tag].reserve(64);
+	}
+}
+
+// an entity that has no velocity, no gravity and nothing else driving it can never
+// start moving on its own, so it is put to sleep as soon as it is added
+static bool is_dormant(const Entity &entity)
+{
+	return entity.get_component<c_Transform>().velocity == c_Vec2(0, 0)
+		&& !entity.has_component<c_Gravity>()
+		&& !entity.has_component<c_Lifespan>()
+		&& !entity.has_component<c_Input>();
+}
 
 void Entity_Manager::update()
 {
@@ -15,6 +46,25 @@ void Entity_Manager::update()
 		// map[key] will create an element at 'key' if it does not already exist 
 		//			therefore we are not in danger of adding to a vector that doesn't exist
 		m_entity_map[e->m_tag].push_back(e);
+		e->m_manager= this;
+
+		// only entities that are awake go in the active set
+		if (!e->m_asleep && is_dormant(*e))
+		{
+			auto &transform= e->get_component<c_Transform>();
+			transform.previous_position= transform.position;
+			e->m_asleep= true;
+		}
+		if (!e->m_asleep && !m_awake_dirty)
+		{
+			m_awake_entities.push_back(e);
+			m_awake_map[e->m_tag].push_back(e);
+		}
+
+		for (auto &view : m_views)
+		{
+			if (!view.dirty && matches(view, *e)) { view.entities.push_back(e); }
+		}
 	}
 
 	// clear the temporary vector since we have added everything
@@ -31,6 +81,146 @@ void Entity_Manager::update()
 		//	  value (kv.second): the vector storing entities
 		remove_dead_entities(kv.second);
 	}
+
+	for (auto &view : m_views)
+	{
+		if (view.awake && m_awake_dirty) { view.dirty= true; }
+		if (!view.dirty)				 { remove_dead_entities(view.entities); }
+	}
+
+	// the active set is only rebuilt when something fell asleep,
+	// otherwise it is maintained the same way as the other vectors
+	if (m_awake_dirty)
+	{
+		rebuild_awake_entities();
+	}
+	else
+	{
+		remove_dead_entities(m_awake_entities);
+		for (auto &kv : m_awake_map)
+		{
+			remove_dead_entities(kv.second);
+		}
+	}
+}
+
+void Entity_Manager::rebuild_awake_entities()
+{
+	m_awake_entities.clear();
+	for (auto &kv : m_awake_map)
+	{
+		kv.second.clear();
+	}
+
+	for (auto &e : m_entities)
+	{
+		if (!e->m_asleep)
+		{
+			m_awake_entities.push_back(e);
+			m_awake_map[e->m_tag].push_back(e);
+		}
+	}
+
+	m_awake_dirty= false;
+}
+
+bool Entity_Manager::matches(const view_list &view, const Entity &entity) const
+{
+	return (entity.m_signature & view.signature) == view.signature && !(view.awake && entity.m_asleep)
+		&& !(view.tagged && entity.m_tag != view.tag);
+}
+
+void Entity_Manager::rebuild_view(view_list &view)
+{
+	view.entities.clear();
+	for (auto &e : m_entities)
+	{
+		if (matches(view, *e)) { view.entities.push_back(e); }
+	}
+	view.dirty= false;
+}
+
+void Entity_Manager::invalidate_views()
+{
+	for (auto &view : m_views)
+	{
+		view.dirty= true;
+	}
+}
+
+// the list for a signature, made on its first query and sized like the entity vector
+// so keeping it up to date never allocates
+const EntityVec &Entity_Manager::matching(uint32_t signature, bool awake, bool tagged, e_Tag tag)
+{
+	for (auto &view : m_views)
+	{
+		if (view.signature == signature && view.awake == awake && view.tagged == tagged && (!tagged || view.tag == tag))
+		{
+			if (view.dirty) { rebuild_view(view); }
+			return view.entities;
+		}
+	}
+
+	m_views.push_back({ signature, awake, tagged, tag, true, EntityVec(m_resource) });
+	m_views.back().entities.reserve(m_entities.capacity());
+	rebuild_view(m_views.back());
+	return m_views.back().entities;
+}
+
+// makes room for this many live entities so that spawning up to that
+// many never has to grow a vector or the entity pool. Call it once at load with
+// the level's peak, growing later wastes the old blocks in a monotonic arena
+void Entity_Manager::reserve(size_t entities)
+{
+	pool()->reserve(entities);
+	m_entities.reserve(entities);
+	m_entities_to_add.reserve(entities);
+	m_awake_entities.reserve(entities);
+
+	for (e_Tag tag : ALL_TAGS)
+	{
+		m_entity_map[tag].reserve(entities);
+		m_awake_map[tag].reserve(entities);
+	}
+	for (auto &view : m_views)
+	{
+		view.entities.reserve(entities);
+	}
+}
+
+// drops every entity but keeps the capacity, the id counter continues from total_entities
+void Entity_Manager::clear(size_t total_entities)
+{
+	m_entities.clear();
+	m_entities_to_add.clear();
+	m_awake_entities.clear();
+
+	for (auto &kv : m_entity_map)
+	{
+		kv.second.clear();
+	}
+	for (auto &kv : m_awake_map)
+	{
+		kv.second.clear();
+	}
+	for (auto &view : m_views)
+	{
+		view.entities.clear();
+		view.dirty= false;
+	}
+
+	m_awake_dirty= false;
+	m_total_entities= total_entities;
+}
+
+// the pool's control block comes from the resource as well, so nothing the manager owns is on the heap
+const std::shared_ptr<Block_Pool> &Entity_Manager::pool()
+{
+	if (!m_pool)
+	{
+		m_pool= std::allocate_shared<Block_Pool>(std::pmr::polymorphic_allocator<Block_Pool>(m_resource), 256, m_resource);
+	}
+	return m_pool;
 }
 
 // iterates through a passed vector and erases any inactive entities
@@ -53,13 +243,102 @@ void Entity_Manager::remove_dead_entities(EntityVec &vec)
 // pushes an entity to the 'to_add' vector, which will be added to the entity vectors in the update() method
 std::shared_ptr<Entity> Entity_Manager::add_entity(const enum e_Tag &tag)
 {
-	auto entity = std::shared_ptr<Entity>(new Entity(m_total_entities++, tag));
+	// the entity and its control block share one pooled block
+	auto entity= std::allocate_shared<Entity>(Pool_Allocator<Entity>(pool()), m_total_entities++, tag);
 
 	m_entities_to_add.push_back(entity);
 	
 	return entity;
 }
 
+// a copy of the prefab's components, pending like any other new entity
+std::shared_ptr<Entity> Entity_Manager::add_entity(const Prefab &prefab)
+{
+	auto entity= std::allocate_shared<Entity>(Pool_Allocator<Entity>(pool()), m_total_entities++, prefab);
+
+	m_entities_to_add.push_back(entity);
+
+	return entity;
+}
+
+// makes room for this many entities on top of those already in the manager or pending.
+// In the level arena a vector that grows leaves its old block behind until the level is
+// reset, so growth is at least doubled, which keeps what is left behind smaller than the
+// vectors themselves however often this is called
+void Entity_Manager::reserve_more(size_t entities)
+{
+	size_t needed= m_entities.size() + m_entities_to_add.size() + entities;
+	if (needed > m_entities.capacity())
+	{
+		needed= std::max(needed, m_entities.capacity() * 2);
+	}
+	reserve(needed);
+}
+
+// recreates an entity with a known id straight into the entity vectors, used when loading a snapshot.
+// entities must be restored in ascending id order to keep the vectors in the order add_entity makes
+std::shared_ptr<Entity> Entity_Manager::restore_entity(size_t id, const enum e_Tag &tag, bool asleep)
+{
+	auto entity= std::allocate_shared<Entity>(Pool_Allocator<Entity>(pool()), id, tag);
+	entity->m_asleep= asleep;
+	entity->m_manager= this;
+	invalidate_views();
+
+	m_entities.push_back(entity);
+	m_entity_map[tag].push_back(entity);
+	if (!asleep)
+	{
+		m_awake_entities.push_back(entity);
+		m_awake_map[tag].push_back(entity);
+	}
+
+	return entity;
+}
+
+// sleeping entities are skipped by movement and collision until they are woken
+void Entity_Manager::sleep(const std::shared_ptr<Entity> &entity)
+{
+	if (entity->m_asleep) { return; }
+
+	// a sleeping entity does not move, so its previous position is its current one
+	auto &transform= entity->get_component<c_Transform>();
+	transform.previous_position= transform.position;
+
+	entity->m_asleep= true;
+	m_awake_dirty= true;
+}
+
+// a woken entity joins the active set straight away so the systems that run later in
+// the same frame see it. It goes where a rebuild would put it, the vectors are in id order
+void Entity_Manager::wake(const std::shared_ptr<Entity> &entity)
+{
+	if (!entity->m_asleep) { return; }
+
+	entity->m_asleep= false;
+
+	// one still pending joins the active set when update() adds it
+	if (entity->m_manager != this) { return; }
+
+	insert_in_order(m_awake_entities, entity);
+	insert_in_order(m_awake_map[entity->m_tag], entity);
+	for (auto &view : m_views)
+	{
+		if (view.awake && !view.dirty && matches(view, *entity)) { insert_in_order(view.entities, entity); }
+	}
+}
+
+void Entity_Manager::insert_in_order(EntityVec &vec, const std::shared_ptr<Entity> &entity)
+{
+	auto at= std::upper_bound(vec.begin(), vec.end(), entity->m_id,
+							  [](size_t id, const std::shared_ptr<Entity> &e) { return id < e->m_id; });
+	vec.insert(at, entity);
+}
+
+size_t Entity_Manager::total_entities() const
+{
+	return m_total_entities;
+}
+
 const EntityVec &Entity_Manager::get_entities()
 {
 	return m_entities;
@@ -68,4 +347,14 @@ const EntityVec &Entity_Manager::get_entities()
 const EntityVec &Entity_Manager::get_entities(const enum e_Tag &tag)
 {
 	return m_entity_map[tag];
+}
+
+const EntityVec &Entity_Manager::get_awake_entities()
+{
+	return m_awake_entities;
+}
+
+const EntityVec &Entity_Manager::get_awake_entities(const enum e_Tag &tag)
+{
+	return m_awake_map[tag];
 }
\ No newline at end of file
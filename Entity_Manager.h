@@ -2,27 +2,135 @@
 
 #include "Common.h"
 #include "Entity.h"
+#include "Pool_Allocator.h"
+#include "Prefab.h"
 
-typedef std::vector<std::shared_ptr<Entity>> EntityVec;
-typedef std::map<enum e_Tag, EntityVec> EntityMap;
+#include <deque>
+#include <map>
+#include <memory_resource>
+
+// every container takes its memory from the resource the manager was given, normally
+// the scene's level arena
+typedef std::pmr::vector<std::shared_ptr<Entity>> EntityVec;
+typedef std::pmr::map<enum e_Tag, EntityVec> EntityMap;
+
+// The entities that have every one of Ts, iterating yields the entity and references to
+// those components: for (auto [e, transform, gravity] : view<c_Transform, c_Gravity>())
+template <typename... Ts>
+class Entity_View
+{
+	const EntityVec &m_entities;
+
+public:
+
+	class iterator
+	{
+		EntityVec::const_iterator m_it;
+
+	public:
+
+		iterator(EntityVec::const_iterator it) : m_it(it) {}
+
+		std::tuple<Entity &, Ts &...> operator*() const { return { **m_it, (*m_it)->template get_component<Ts>()... }; }
+		iterator &operator++() { ++m_it; return *this; }
+		bool operator!=(const iterator &rhs) const { return m_it != rhs.m_it; }
+	};
+
+	Entity_View(const EntityVec &entities) : m_entities(entities) {}
+
+	iterator begin() const { return iterator(m_entities.begin()); }
+	iterator end()	 const { return iterator(m_entities.end()); }
+	size_t	 size()	 const { return m_entities.size(); }
+	bool	 empty() const { return m_entities.empty(); }
+};
 
 class Entity_Manager
 {
+	friend class Entity;
+
+	// the entities matching one signature, kept in the same order as m_entities. A view is
+	// updated as entities come, go and wake up, and rebuilt on its next query when an entity
+	// already in the manager gains or loses a component, or any entity falls asleep
+	struct view_list
+	{
+		uint32_t  signature= 0;
+		bool	  awake= false;		// only entities that are awake
+		bool	  tagged= false;	// only entities with the tag
+		e_Tag	  tag= e_Tag::Default;
+		bool	  dirty= false;
+		EntityVec entities;
+	};
+
+	std::pmr::memory_resource *m_resource;
+
 	EntityVec m_entities;
 	EntityVec m_entities_to_add;
 	EntityMap m_entity_map;
+	EntityVec m_awake_entities;
+	EntityMap m_awake_map;
+	bool	  m_awake_dirty= false;
 	size_t	  m_total_entities= 0;
 
+	// views are handed out by reference, a deque never moves its elements as it grows
+	std::pmr::deque<view_list> m_views;
+
+	std::shared_ptr<Block_Pool> m_pool;
+
 	void remove_dead_entities(EntityVec& vec);
+	const std::shared_ptr<Block_Pool> &pool();
+	void rebuild_awake_entities();
+	void insert_in_order(EntityVec &vec, const std::shared_ptr<Entity> &entity);
+
+	bool matches(const view_list &view, const Entity &entity) const;
+	void rebuild_view(view_list &view);
+	void invalidate_views();
+	const EntityVec &matching(uint32_t signature, bool awake, bool tagged= false, e_Tag tag= e_Tag::Default);
 
 public:
 
-	Entity_Manager();
+	Entity_Manager(std::pmr::memory_resource *resource= std::pmr::get_default_resource());
+
+	Entity_Manager(const Entity_Manager &)= delete;
+	Entity_Manager &operator=(const Entity_Manager &)= delete;
 
 	void update();
+	void reserve(size_t entities);
+	void clear(size_t total_entities);
 
 	std::shared_ptr<Entity> add_entity(const enum e_Tag &tag);
+	std::shared_ptr<Entity> add_entity(const Prefab &prefab);
+	void					reserve_more(size_t entities);
+
+	// adds count copies of a prefab, calling init(entity, i) to place the i-th one. Room
+	// for all of them is made first, then each is one pooled block and one block copy
+	template <typename F>
+	void add_entities(const Prefab &prefab, size_t count, F init)
+	{
+		reserve_more(count);
+		for (size_t i= 0; i < count; i++)
+		{
+			init(*add_entity(prefab), i);
+		}
+	}
+	std::shared_ptr<Entity> restore_entity(size_t id, const enum e_Tag &tag, bool asleep);
+
+	void sleep(const std::shared_ptr<Entity> &entity);
+	void wake(const std::shared_ptr<Entity> &entity);
+
+	size_t total_entities() const;
 
 	const EntityVec &get_entities();
 	const EntityVec &get_entities(const enum e_Tag &tag);
+	const EntityVec &get_awake_entities();
+	const EntityVec &get_awake_entities(const enum e_Tag &tag);
+
+	template <typename... Ts>
+	Entity_View<Ts...> view() { return Entity_View<Ts...>(matching(signature_of<Ts...>(), false)); }
+
+	template <typename... Ts>
+	Entity_View<Ts...> awake_view() { return Entity_View<Ts...>(matching(signature_of<Ts...>(), true)); }
+
+	// only the entities of one tag, for a few entities picked out of many of that tag
+	template <typename... Ts>
+	Entity_View<Ts...> view(const enum e_Tag &tag) { return Entity_View<Ts...>(matching(signature_of<Ts...>(), false, true, tag)); }
 };
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Common.h"
+#include "Entity.h"
+
+#include <tuple>
+
+// Events are emitted by detection systems and consumed later in the frame by the
+// systems that own the consequences. They only hold raw entity pointers, which stay
+// valid until the Entity_Manager removes dead entities at the start of the next frame,
+// and projectile indices, which stay valid until the projectiles next update
+
+class Bullet_Hit_Tile
+{
+public:
+	uint32_t projectile= 0;
+	Entity	*tile=		 nullptr;
+};
+
+class Bullet_Hit_Enemy
+{
+public:
+	uint32_t projectile= 0;
+	Entity	*enemy=		 nullptr;
+};
+
+class Player_Bump_Tile
+{
+public:
+	Entity *tile= nullptr;	// the tile the player hit from below
+};
+
+class Player_Stomp
+{
+public:
+	Entity *enemy= nullptr;
+};
+
+class Player_Hurt
+{
+public:
+	Entity *enemy= nullptr;	// nullptr when the player fell out of the level
+};
+
+class Flag_Reached
+{
+public:
+	size_t record= 0;		// the level record of the flag passed
+};
+
+class Enemy_Lost
+{
+public:
+	Entity *enemy= nullptr;	// fell down a hole or walked off the left of the level
+};
+
+// A queue of one event type. Storage is reserved once and reused every frame, a frame
+// that emits more events than were reserved grows the queue instead of losing them,
+// and that allocation shows up in the Alloc_Tracker report of the emitting system
+template <typename T>
+class Event_Queue
+{
+	std::vector<T> m_events;
+
+public:
+
+	Event_Queue(size_t capacity= 256)
+	{
+		m_events.reserve(capacity);
+	}
+
+	void push(const T &event)
+	{
+		m_events.push_back(event);
+	}
+
+	void clear()
+	{
+		m_events.clear();
+	}
+
+	void reserve(size_t capacity)
+	{
+		m_events.reserve(capacity);
+	}
+
+	bool	empty()	const { return m_events.empty(); }
+	size_t	size()	const { return m_events.size(); }
+
+	typename std::vector<T>::const_iterator begin() const { return m_events.begin(); }
+	typename std::vector<T>::const_iterator end()	const { return m_events.end(); }
+};
+
+typedef std::tuple<
+	Event_Queue<Bullet_Hit_Tile>,
+	Event_Queue<Bullet_Hit_Enemy>,
+	Event_Queue<Player_Bump_Tile>,
+	Event_Queue<Player_Stomp>,
+	Event_Queue<Player_Hurt>,
+	Event_Queue<Flag_Reached>,
+	Event_Queue<Enemy_Lost>
+> EventQueueTuple;
+
+class Event_Bus
+{
+	EventQueueTuple m_queues;
+
+public:
+
+	template <typename T>
+	void emit(const T &event)
+	{
+		std::get<Event_Queue<T>>(m_queues).push(event);
+	}
+
+	template <typename T>
+	const Event_Queue<T> &get() const
+	{
+		return std::get<Event_Queue<T>>(m_queues);
+	}
+
+	// raises the capacity of one queue, for events that can come in bulk
+	template <typename T>
+	void reserve(size_t capacity)
+	{
+		std::get<Event_Queue<T>>(m_queues).reserve(capacity);
+	}
+
+	// empties every queue without giving back their storage
+	void clear()
+	{
+		std::apply([](auto &... queue) { (queue.clear(), ...); }, m_queues);
+	}
+};
@@ -0,0 +1,114 @@
+#include "Frame_Pacer.h"
+
+#include <algorithm>
+
+Frame_Pacer::Frame_Pacer(unsigned rate, e_Pacing pacing)
+	: m_pacing(pacing)
+{
+	set_rate(rate);
+}
+
+void Frame_Pacer::set_rate(unsigned rate)
+{
+	m_period= std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(rate, 1u)));
+	reset();
+}
+
+void Frame_Pacer::set_pacing(e_Pacing pacing)
+{
+	m_pacing= pacing;
+	reset();
+}
+
+// forgets the schedule and the statistics, the next wait() starts a new schedule
+void Frame_Pacer::reset()
+{
+	m_oversleep=	std::min<Clock::duration>(std::chrono::milliseconds(2), m_period / 4);
+	m_started=		false;
+	m_frames=		0;
+	m_missed=		0;
+	m_frame_times=	Latency_Stats();
+	m_jitter=		Latency_Stats();
+}
+
+// sleeps and learns how late it woke, a late wake is taken on at once and
+// an early one only slowly so one lucky sleep doesn't shrink the spin.
+// One freak wake, a page fault or a window drag, is capped at a quarter of the
+// period, and a wait too short to sleep still lets the estimate come down, so
+// the spin can never grow to take the whole wait for good
+void Frame_Pacer::sleep_until(Clock::time_point time)
+{
+	Clock::time_point now= Clock::now();
+	if (time <= now)
+	{
+		m_oversleep-= m_oversleep / 64;
+		return;
+	}
+
+	sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(time - now).count()));
+
+	Clock::duration late= std::min<Clock::duration>(Clock::now() - time, m_period / 4);
+	if (late > m_oversleep) { m_oversleep= late; }
+	else					{ m_oversleep-= (m_oversleep - late) / 64; }
+}
+
+// blocks until the next frame is due, called once per frame between presenting one and starting the next
+void Frame_Pacer::wait()
+{
+	Clock::time_point now= Clock::now();
+
+	if (!m_started)
+	{
+		m_started=	  true;
+		m_last_frame= now;
+		m_deadline=	  now + m_period;
+		return;
+	}
+
+	if (m_pacing == e_Pacing::Sleep)
+	{
+		// like setFramerateLimit: sleep out what is left of the period since the last frame
+		if (now - m_last_frame >= m_period) { m_missed++; }
+		else								{ sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(m_period - (now - m_last_frame)).count())); }
+	}
+	else if (now >= m_deadline)
+	{
+		// a frame that overran starts right away and the schedule moves with it,
+		// catching up would only run the following frames back to back
+		m_missed++;
+		m_deadline= now;
+	}
+	else
+	{
+		sleep_until(m_deadline - m_oversleep - m_oversleep / 4);
+		while (Clock::now() < m_deadline) {}
+	}
+
+	Clock::time_point start= Clock::now();
+	Clock::duration frame_time= start - m_last_frame;
+
+	m_frame_times.record(frame_time);
+	m_jitter.record(frame_time > m_period ? frame_time - m_period : m_period - frame_time);
+	m_frames++;
+
+	m_last_frame= start;
+	m_deadline+=  m_period;
+}
+
+size_t Frame_Pacer::frames() const
+{
+	return m_frames;
+}
+
+size_t Frame_Pacer::missed() const
+{
+	return m_missed;
+}
+
+void Frame_Pacer::report(std::ostream &out) const
+{
+	out << m_frames << " frames at " << std::chrono::duration<double>(1) / m_period << " Hz, "
+		<< m_missed << " missed deadlines, " << (m_pacing == e_Pacing::Hybrid ? "hybrid" : "sleep") << " pacing\n";
+	m_frame_times.report(out, "  frame time");
+	m_jitter.report(out, "  jitter");
+}
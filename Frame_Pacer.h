@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common.h"
+#include "Input_Capture.h"
+
+#include <chrono>
+
+enum class e_Pacing { Sleep, Hybrid };
+
+// Starts frames on a fixed schedule kept on steady_clock. Hybrid pacing sleeps through most
+// of the wait and spins through the last stretch, which is sized from how late sleeps have
+// been waking up, so frames start within a few microseconds of their deadline.
+// Sleep pacing is what setFramerateLimit does, it is kept to compare against
+class Frame_Pacer
+{
+	typedef std::chrono::steady_clock Clock;
+
+	e_Pacing			m_pacing= e_Pacing::Hybrid;
+	Clock::duration		m_period;
+	Clock::duration		m_oversleep;			// how late a sleep wakes, the spin covers this much
+	Clock::time_point	m_deadline;				// when the next frame is due to start
+	Clock::time_point	m_last_frame;
+	bool				m_started= false;
+	size_t				m_frames= 0;
+	size_t				m_missed= 0;			// frames that were still running at their deadline
+	Latency_Stats		m_frame_times;
+	Latency_Stats		m_jitter;				// how far each frame time was from the period
+
+	void sleep_until(Clock::time_point time);
+
+public:
+
+	Frame_Pacer(unsigned rate= 60, e_Pacing pacing= e_Pacing::Hybrid);
+
+	void set_rate(unsigned rate);
+	void set_pacing(e_Pacing pacing);
+	void reset();
+	void wait();
+
+	size_t frames() const;
+	size_t missed() const;
+	void   report(std::ostream &out) const;
+};
@@ -2,18 +2,32 @@
 #include "Assets.h"
 #include "Scene_Play.h"
 #include "Scene_Menu.h"
+#include "Alloc_Tracker.h"
+#include "Trace.h"
+
+#include <cassert>
 
 Game_Engine::Game_Engine(const std::string &path)
 {
 	initialize(path);
 }
 
+Game_Engine::~Game_Engine()
+{
+	m_renderer.stop();
+}
+
 void Game_Engine::initialize(const std::string &path)
 {
 	m_assets.load_from_file(path);
+	m_prefabs.load_from_file("prefabs.txt", m_assets);
 
 	m_window.create(sf::VideoMode(1280, 768), "Definitely Not Mario");
-	m_window.setFramerateLimit(60);
+	m_renderer.start(m_window, m_render_backend);
+
+	m_frame_inputs.reserve(64);
+	m_input_capture.set_focus(m_window.hasFocus());
+	m_input_capture.start();
 
 	change_scene("MENU", std::make_shared<Scene_Menu>(this));
 }
@@ -33,21 +47,62 @@ const Assets &Game_Engine::assets() const
 	return m_assets;
 }
 
+const Prefab_Library &Game_Engine::prefabs() const
+{
+	return m_prefabs;
+}
+
+Audio_Mixer &Game_Engine::audio()
+{
+	return m_audio;
+}
+
 sf::RenderWindow &Game_Engine::window()
 {
 	return m_window;
 }
 
+// the list the current tick draws into, it goes to the render thread when the tick ends
+Render_List &Game_Engine::render_list()
+{
+	return m_renderer.back_frame().list;
+}
+
 void Game_Engine::run()
 {
+	// frames are paced here rather than by setFramerateLimit, whose plain sleep
+	// wakes late by an uneven amount every frame
 	while (is_running())
 	{
 		update();
+		m_pacer.wait();
+	}
+
+	m_input_capture.stop();
+	m_renderer.stop();
+
+	// a capture still running when the game closes is written out rather than lost
+	if (Trace::capturing())
+	{
+		toggle_trace();
+	}
+
+	if (m_latency_report)
+	{
+		report_latency(std::cout);
+	}
+
+	if (m_pace_report)
+	{
+		m_pacer.report(std::cout);
 	}
 }
 
 void Game_Engine::s_user_input()
 {
+	ALLOC_SCOPE("s_user_input");
+
+	// window events still come through SFML, but keys are read from the capture thread
 	sf::Event event;
 	while (m_window.pollEvent(event))
 	{
@@ -55,27 +110,117 @@ void Game_Engine::s_user_input()
 		{
 			quit();
 		}
+		else if (event.type == sf::Event::GainedFocus || event.type == sf::Event::LostFocus)
+		{
+			m_input_capture.set_focus(event.type == sf::Event::GainedFocus);
+		}
+	}
 
-		if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased)
+	input_event input;
+	while (m_input_capture.pop(input))
+	{
+		// F9 belongs to the engine in every scene
+		if (input.key == sf::Keyboard::F9)
 		{
-			// if the current scene does not have an action associated with this key, skip the event
-			if (current_scene()->get_action_map().find(event.key.code) == current_scene()->get_action_map().end()) { continue; }
+			m_trace_toggle|= input.pressed;
+			continue;
+		}
+
+		// if the current scene does not have an action associated with this key, skip the event
+		e_Action action= m_scene->get_action(input.key);
+		if (action == e_Action::None) { continue; }
 
-			// determine the start or end action by whether it was key press or release
-			const std::string action_type= (event.type == sf::Event::KeyPressed) ? "START" : "END";
+		// determine the start or end action by whether it was key press or release
+		e_Action_Type action_type= input.pressed ? e_Action_Type::Start : e_Action_Type::End;
 
-			// look up the action and send the action to the scene
-			current_scene()->do_action(Action(current_scene()->get_action_map().at(event.key.code), action_type));
+		m_input_to_simulation.record(Input_Clock::now() - input.time);
+		if (m_frame_inputs.size() < m_frame_inputs.capacity())
+		{
+			m_frame_inputs.push_back(input.time);
 		}
+
+		// send the action to the scene along with when the key was captured
+		m_scene->do_action(Action(action, action_type, input.time));
 	}
 }
 
+// scene changes never happen in the middle of a frame, the scene asking for one may still
+// be running, so the change is applied by swap_scenes() when the next frame starts
 void Game_Engine::change_scene(const std::string &scene_name, std::shared_ptr<Scene> scene, bool end_current_scene)
 {
+	TRACE_SCOPE("change_scene");
+
+	m_scene_change.pending= true;
+	m_scene_change.name= scene_name;
+	m_scene_change.load_key.clear();
+	m_scene_change.scene= scene;
+	abandon_load(m_scene_change.loading);
+	m_scene_change.end_current_scene= end_current_scene;
+
+	// asking for a scene change is a transition too, the frame that does it may allocate
+	m_steady_frames= 0;
+}
+
+// like change_scene, but the scene is built on a background thread and swapped in at the
+// first frame boundary after it is ready. A scene preloaded under the same key is used if there is one
+void Game_Engine::change_scene_async(const std::string &scene_name, const std::string &load_key, const Scene_Builder &build, bool end_current_scene)
+{
+	// asking again for the same load while it is still pending changes nothing
+	if (m_scene_change.pending && m_scene_change.load_key == load_key && m_scene_change.name == scene_name) { return; }
+
+	preload_scene(load_key, build);
+
+	change_scene(scene_name, nullptr, end_current_scene);
+	m_scene_change.load_key= load_key;
+	m_scene_change.loading= std::move(m_scene_loads[load_key]);
+	m_scene_loads.erase(load_key);
+}
+
+// starts building a scene in the background so a later change_scene_async with this key is instant
+void Game_Engine::preload_scene(const std::string &load_key, const Scene_Builder &build)
+{
+	if (m_scene_loads.find(load_key) != m_scene_loads.end()) { return; }
+
+	m_scene_loads[load_key]= std::async(std::launch::async, [build]()
+	{
+		Trace::name_thread("scene loader");
+		return build();
+	});
+}
+
+// the future of a std::async load blocks in its destructor until the load is done, so
+// a load that is no longer wanted is parked and only dropped once it has finished
+void Game_Engine::abandon_load(std::future<std::shared_ptr<Scene>> &loading)
+{
+	if (loading.valid())
+	{
+		m_abandoned_loads.push_back(std::move(loading));
+	}
+}
+
+// applies the pending scene change, if there is one and its scene has finished loading
+void Game_Engine::swap_scenes()
+{
+	std::erase_if(m_abandoned_loads, [](const std::future<std::shared_ptr<Scene>> &load)
+	{
+		return load.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	});
+
+	if (!m_scene_change.pending) { return; }
+
+	if (m_scene_change.loading.valid())
+	{
+		if (m_scene_change.loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) { return; }
+
+		m_scene_change.scene= m_scene_change.loading.get();
+	}
+
+	const std::string &scene_name= m_scene_change.name;
+
 	// If a scene was passed, add it to the map with the scene name
-	if (scene)
+	if (m_scene_change.scene)
 	{
-		m_scene_map[scene_name]= scene;
+		m_scene_map[scene_name]= m_scene_change.scene;
 	}
 	else
 	{
@@ -87,23 +232,135 @@ void Game_Engine::change_scene(const std::string &scene_name, std::shared_ptr<Sc
 		}
 	}
 
-	if (end_current_scene)
+	if (m_scene_change.end_current_scene && m_current_scene != scene_name)
 	{
-		m_scene_map.erase(m_scene_map.find(m_current_scene));
+		m_scene_map.erase(m_current_scene);
 	}
 
 	m_current_scene= scene_name;
+	m_scene= m_scene_map[m_current_scene].get();
+	Trace::instant("swap_scenes");
+
+	m_scene_change.pending= false;
+	m_scene_change.scene= nullptr;
+	m_scene_change.load_key.clear();
+
+	// a new scene allocates while it warms up, so steady state starts over
+	m_steady_frames= 0;
 }
 
 void Game_Engine::update()
 {
 	if (!is_running()) { return; }
 
+	// captures start and stop between frames, so a trace only ever holds whole frames
+	if (m_trace_toggle)
+	{
+		toggle_trace();
+	}
+
+	TRACE_SCOPE("Game_Engine::update");
+
+	// the frame boundary, the only place the current scene is ever replaced
+	swap_scenes();
+
 	if (m_scene_map.empty()) { return; }
 
+	Alloc_Tracker::begin_frame();
+
 	s_user_input();
-	current_scene()->update();	
-	window().display();
+	m_scene->update();
+	m_audio.advance();
+
+	// the render thread measures the inputs to when the frame is on screen, the frame may
+	// already hold those of frames it replaced, which only fill it up when nothing is drawn
+	Render_Frame &frame= m_renderer.back_frame();
+	size_t room= frame.inputs.capacity() - frame.inputs.size();
+	frame.inputs.insert(frame.inputs.end(), m_frame_inputs.begin(), m_frame_inputs.begin() + std::min(room, m_frame_inputs.size()));
+	m_frame_inputs.clear();
+	m_renderer.publish();
+
+	check_allocations();
+}
+
+// reports frames that allocated and, when asserting, fails on any allocation once
+// the scene has been running long enough to reach its steady state
+void Game_Engine::check_allocations()
+{
+	if (!Alloc_Tracker::enabled()) { return; }
+
+	size_t allocations= Alloc_Tracker::frame_allocations();
+	bool steady= m_steady_frames >= m_warmup_frames;
+	m_steady_frames++;
+
+	if (allocations == 0) { return; }
+
+	if (m_alloc_report || (m_alloc_assert && steady))
+	{
+		Alloc_Tracker::report(std::cerr, m_scene->current_frame());
+	}
+
+	assert(!(m_alloc_assert && steady) && "a steady-state frame allocated");
+}
+
+void Game_Engine::set_alloc_checks(bool report, bool assert_steady)
+{
+	m_alloc_report= report;
+	m_alloc_assert= assert_steady;
+}
+
+void Game_Engine::set_latency_report(bool report)
+{
+	m_latency_report= report;
+}
+
+void Game_Engine::set_trace_path(const std::string &path)
+{
+	m_trace_path= path;
+}
+
+void Game_Engine::set_frame_rate(unsigned rate)
+{
+	m_pacer.set_rate(rate);
+	m_audio.set_frame_rate(rate);
+}
+
+void Game_Engine::set_pace_report(bool report)
+{
+	m_pace_report= report;
+}
+
+// starts a capture, or stops the running one and writes it to the trace path
+void Game_Engine::toggle_trace()
+{
+	m_trace_toggle= false;
+
+	if (!Trace::capturing())
+	{
+		Trace::start();
+		std::cout << "Trace capture started, press F9 again to write " << m_trace_path << "\n";
+		return;
+	}
+
+	if (Trace::stop(m_trace_path))
+	{
+		std::cout << "Trace written to " << m_trace_path << ", " << Trace::dropped() << " events dropped\n";
+	}
+	else
+	{
+		std::cerr << "Could not write trace file: " << m_trace_path << std::endl;
+	}
+}
+
+void Game_Engine::report_latency(std::ostream &out) const
+{
+	m_input_to_simulation.report(out, "input to simulation");
+	m_renderer.input_to_present().report(out, "input to present");
+
+	if (m_input_capture.dropped() > 0)
+	{
+		out << m_input_capture.dropped() << " input events dropped\n";
+	}
 }
 
 void Game_Engine::quit()
@@ -3,24 +3,71 @@
 #include "Common.h"
 #include "Scene.h"
 #include "Assets.h"
+#include "Prefab.h"
+#include "Input_Capture.h"
+#include "Frame_Pacer.h"
+#include "Render_Thread.h"
+#include "Audio_Mixer.h"
 
 #include <memory>
+#include <future>
 
 typedef std::map<std::string, std::shared_ptr<Scene>> Scene_Map;
+typedef std::map<std::string, std::future<std::shared_ptr<Scene>>> Scene_Loads;
 
 class Game_Engine
 {
+	// a scene change waiting for the next frame boundary, and possibly for its scene to finish loading
+	struct scene_change
+	{
+		bool									pending= false;
+		std::string								name;
+		std::string								load_key;
+		std::shared_ptr<Scene>					scene;
+		std::future<std::shared_ptr<Scene>>		loading;
+		bool									end_current_scene= false;
+	};
+
 protected:
 
 	sf::RenderWindow	m_window;
 	Assets				m_assets;
+	Prefab_Library		m_prefabs;				// read once, every level copies it and tunes its copy
+	Audio_Mixer			m_audio{ m_assets, std::make_unique<SFML_Audio_Device>(16) };
 	std::string			m_current_scene;
 	Scene_Map			m_scene_map;
+	Scene			   *m_scene= nullptr;		// the current scene, cached so input and update skip the map
+	scene_change		m_scene_change;
+	Scene_Loads			m_scene_loads;			// scenes being built in the background, by load key
+	std::vector<std::future<std::shared_ptr<Scene>>> m_abandoned_loads;	// loads no longer wanted, dropped once they finish
 	size_t				m_simulation_speed= 1;
 	bool				m_running= true;
+	bool				m_alloc_report= false;
+	bool				m_alloc_assert= false;
+	size_t				m_warmup_frames= 60;
+	size_t				m_steady_frames= 0;
+
+	Input_Capture		m_input_capture;
+	Latency_Stats		m_input_to_simulation;
+	bool				m_latency_report= false;
+	std::vector<Input_Clock::time_point> m_frame_inputs;	// capture times of this frame's actions
+
+	Frame_Pacer			m_pacer;
+	bool				m_pace_report= false;
+
+	// declared after the window so they stop before the window goes away
+	SFML_Render_Backend	m_render_backend{ m_window, m_assets };
+	Render_Thread		m_renderer;
+
+	std::string			m_trace_path= "trace.json";
+	bool				m_trace_toggle= false;	// F9 was pressed, the capture starts or stops between frames
 
 	void initialize(const std::string &path);
 	void update();
+	void check_allocations();
+	void swap_scenes();
+	void abandon_load(std::future<std::shared_ptr<Scene>> &loading);
+	void toggle_trace();
 
 	void s_user_input();
 
@@ -29,13 +76,25 @@ protected:
 public:
 
 	Game_Engine(const std::string &path);					
+	~Game_Engine();
 
 	void change_scene(const std::string &scene_name, std::shared_ptr<Scene> scene, bool end_current_scene= false);
+	void change_scene_async(const std::string &scene_name, const std::string &load_key, const Scene_Builder &build, bool end_current_scene= false);
+	void preload_scene(const std::string &load_key, const Scene_Builder &build);
 
 	void quit();
 	void run();
+	void set_alloc_checks(bool report, bool assert_steady);
+	void set_latency_report(bool report);
+	void set_trace_path(const std::string &path);
+	void set_frame_rate(unsigned rate);
+	void set_pace_report(bool report);
+	void report_latency(std::ostream &out) const;
 
 	sf::RenderWindow &window();
+	Render_List &render_list();
 	const Assets &assets() const;
+	const Prefab_Library &prefabs() const;
+	Audio_Mixer &audio();
 	bool is_running();
 };
\ No newline at end of file
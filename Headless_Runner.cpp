@@ -0,0 +1,262 @@
+#include "Headless_Runner.h"
+#include "Scene_Play.h"
+#include "Assets.h"
+
+#include <chrono>
+#include <random>
+
+// holds right the whole time and mixes in jumps, shots and the odd step back, the
+// presses are repeated now and then because a restarted level forgets held keys
+Input_Script Input_Script::random(unsigned seed, size_t frames)
+{
+	Input_Script script;
+	std::mt19937 random(seed);
+	auto between= [&](int low, int high) { return (size_t)std::uniform_int_distribution<int>(low, high)(random); };
+
+	for (size_t frame= 0; frame < frames; frame+= 120)
+	{
+		script.add(frame, Action(e_Action::Right, e_Action_Type::Start));
+	}
+
+	for (size_t frame= between(0, 30); frame < frames; frame+= between(20, 60))
+	{
+		script.add(frame, Action(e_Action::Jump, e_Action_Type::Start));
+		script.add(frame + between(5, 25), Action(e_Action::Jump, e_Action_Type::End));
+	}
+
+	for (size_t frame= between(0, 30); frame < frames; frame+= between(15, 45))
+	{
+		script.add(frame, Action(e_Action::Shoot, e_Action_Type::Start));
+		script.add(frame + 2, Action(e_Action::Shoot, e_Action_Type::End));
+	}
+
+	for (size_t frame= between(100, 400); frame < frames; frame+= between(200, 400))
+	{
+		script.add(frame, Action(e_Action::Right, e_Action_Type::End));
+		script.add(frame, Action(e_Action::Left, e_Action_Type::Start));
+		script.add(frame + between(10, 40), Action(e_Action::Left, e_Action_Type::End));
+		script.add(frame + 40, Action(e_Action::Right, e_Action_Type::Start));
+	}
+
+	std::stable_sort(script.m_actions.begin(), script.m_actions.end(),
+		[](const scripted_action &a, const scripted_action &b) { return a.frame < b.frame; });
+
+	return script;
+}
+
+void Input_Script::add(size_t frame, const Action &action)
+{
+	m_actions.push_back({ frame, action });
+}
+
+// sends the scene every action due on this frame
+void Input_Script::apply(Scene &scene, size_t frame)
+{
+	while (m_next < m_actions.size() && m_actions[m_next].frame <= frame)
+	{
+		scene.do_action(m_actions[m_next].action);
+		m_next++;
+	}
+}
+
+Headless_Runner::Headless_Runner(const Assets &assets, const Prefab_Library &prefabs, size_t threads)
+	: m_assets(assets)
+	, m_prefabs(prefabs)
+	, m_pool(threads) {}
+
+void Headless_Runner::add_instance(const std::string &level_path, const Input_Script &script)
+{
+	instance i;
+	i.scene= std::make_shared<Scene_Play>(m_assets, m_prefabs, level_path, 1280, 768);
+	i.script= script;
+	i.list.reserve(8192, 1024);
+	i.audio= std::make_shared<Audio_Mixer>(m_assets, std::make_unique<Null_Audio_Device>(16));
+	i.scene->set_audio(i.audio.get());
+	m_instances.push_back(i);
+}
+
+void Headless_Runner::set_render(bool render)
+{
+	m_render= render;
+}
+
+// recording implies rendering
+void Headless_Runner::set_record(bool record)
+{
+	m_record= record;
+	m_render= m_render || record;
+}
+
+// steps every instance for this many frames, or until its scene ends
+void Headless_Runner::run(size_t frames)
+{
+	auto start= std::chrono::steady_clock::now();
+
+	// made here rather than per instance on the pool, so which one records is fixed
+	for (size_t index= 0; index < m_instances.size() && m_render; index++)
+	{
+		instance &i= m_instances[index];
+		if (i.backend) { continue; }
+
+		if (m_record && index == 0)	{ i.backend= std::make_shared<Recording_Render_Backend>(); }
+		else						{ i.backend= std::make_shared<Null_Render_Backend>(); }
+	}
+
+	m_pool.parallel_for(m_instances.size(), [&](size_t index)
+	{
+		instance &i= m_instances[index];
+		auto instance_start= std::chrono::steady_clock::now();
+
+		size_t frame= i.frames;
+		for (size_t f= 0; f < frames && !i.scene->has_ended(); f++, frame++)
+		{
+			i.script.apply(*i.scene, frame);
+			i.scene->update();
+			i.audio->advance();
+
+			if (m_render)
+			{
+				i.scene->s_render(i.list);
+				i.backend->submit(i.list);
+				i.list.clear();
+			}
+		}
+
+		// written once at the end so neighbouring instances do not share a cache line while running
+		i.frames= frame;
+		i.seconds+= std::chrono::duration<double>(std::chrono::steady_clock::now() - instance_start).count();
+	});
+
+	m_wall_seconds+= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// aggregate throughput, plus how many instances were effectively running at once
+void Headless_Runner::report(std::ostream &out) const
+{
+	size_t total_frames= 0;
+	double busy_seconds= 0;
+	double slowest= 0;
+	double fastest= 0;
+
+	for (auto &i : m_instances)
+	{
+		double fps= i.seconds > 0 ? i.frames / i.seconds : 0;
+		slowest= (total_frames == 0) ? fps : std::min(slowest, fps);
+		fastest= std::max(fastest, fps);
+		total_frames+= i.frames;
+		busy_seconds+= i.seconds;
+	}
+
+	out << m_instances.size() << " instances on " << m_pool.size() << " threads\n";
+	out << total_frames << " frames in " << m_wall_seconds << " s = "
+		<< (m_wall_seconds > 0 ? total_frames / m_wall_seconds : 0) << " frames per second\n";
+	out << "per instance: " << slowest << " to " << fastest << " frames per second\n";
+	out << "instances running at once: " << (m_wall_seconds > 0 ? busy_seconds / m_wall_seconds : 0) << "\n";
+
+	audio_stats sounds;
+	for (auto &i : m_instances)
+	{
+		sounds+= i.audio->stats();
+	}
+	out << "sounds: " << sounds.played << " played (" << sounds.stolen << " on stolen voices), "
+		<< sounds.merged << " merged, " << sounds.dropped << " dropped\n";
+
+	if (m_render)
+	{
+		render_stats work;
+		size_t rendered= 0;
+		for (auto &i : m_instances)
+		{
+			if (!i.backend) { continue; }
+			work+= i.backend->total();
+			rendered+= i.backend->frames();
+		}
+
+		double frames= (double)std::max<size_t>(rendered, 1);
+		out << "per rendered frame: " << work.commands / frames << " commands (" << work.sprites / frames << " sprites, "
+			<< work.lines / frames << " lines, " << work.rects / frames << " rects, " << work.texts / frames << " texts, " << work.grids / frames << " grids) in "
+			<< work.batches / frames << " draw calls\n";
+	}
+}
+
+// checks what reached the render and audio backends against what the scenes produced,
+// prints every failed check and returns whether all passed. Each instance must have
+// rendered every frame it stepped and its null audio device must have been handed every
+// sound its mixer counts as played. When recording, the recorded frame must hold every
+// command of the last list. When every instance was given the same input they must have
+// drawn and played the same amounts, whatever backend they rendered to
+bool Headless_Runner::check(std::ostream &out, bool same_input) const
+{
+	bool passed= true;
+	auto fail= [&](size_t index, const char *what, size_t got, size_t expected)
+	{
+		out << "instance " << index << ": " << what << " " << got << ", expected " << expected << "\n";
+		passed= false;
+	};
+
+	for (size_t index= 0; index < m_instances.size(); index++)
+	{
+		const instance &i= m_instances[index];
+
+		auto device= dynamic_cast<const Null_Audio_Device *>(&i.audio->device());
+		if (device && device->plays() != i.audio->stats().played)
+		{
+			fail(index, "device plays", device->plays(), i.audio->stats().played);
+		}
+
+		if (!m_render) { continue; }
+
+		if (i.backend->frames() != i.frames)
+		{
+			fail(index, "rendered frames", i.backend->frames(), i.frames);
+		}
+
+		// a level frame always draws something, an empty recording means nothing reached it
+		auto recording= dynamic_cast<const Recording_Render_Backend *>(i.backend.get());
+		if (recording && recording->commands().empty())
+		{
+			out << "instance " << index << ": recorded an empty frame\n";
+			passed= false;
+		}
+		else if (recording && recording->commands().size() != recording->stats().commands)
+		{
+			fail(index, "recorded commands", recording->commands().size(), recording->stats().commands);
+		}
+	}
+
+	// the first instance is the reference for every later one
+	for (size_t index= 1; index < m_instances.size() && same_input; index++)
+	{
+		const instance &first= m_instances[0];
+		const instance &i= m_instances[index];
+
+		if (i.frames != first.frames)
+		{
+			fail(index, "frames", i.frames, first.frames);
+			continue;
+		}
+		if (i.audio->stats().played != first.audio->stats().played)
+		{
+			fail(index, "sounds played", i.audio->stats().played, first.audio->stats().played);
+		}
+		if (m_render && i.backend->total().commands != first.backend->total().commands)
+		{
+			fail(index, "render commands", i.backend->total().commands, first.backend->total().commands);
+		}
+	}
+
+	return passed;
+}
+
+// the commands of the first instance's last rendered frame in draw order, false when
+// nothing was recorded
+bool Headless_Runner::write_render(std::ostream &out) const
+{
+	if (m_instances.empty()) { return false; }
+
+	auto recording= dynamic_cast<const Recording_Render_Backend *>(m_instances[0].backend.get());
+	if (!recording || recording->frames() == 0) { return false; }
+
+	recording->write(out);
+	return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Common.h"
+#include "Action.h"
+#include "Thread_Pool.h"
+#include "Render_Backend.h"
+#include "Audio_Mixer.h"
+
+class Assets;
+class Prefab_Library;
+class Scene;
+class Scene_Play;
+
+struct scripted_action
+{
+	size_t frame= 0;
+	Action action;
+};
+
+// A recorded stream of actions for one scene, replayed by frame number
+class Input_Script
+{
+	std::vector<scripted_action> m_actions;		// in frame order
+	size_t						 m_next= 0;
+
+public:
+
+	static Input_Script random(unsigned seed, size_t frames);
+
+	void add(size_t frame, const Action &action);
+	void apply(Scene &scene, size_t frame);
+};
+
+// Steps many headless Scene_Play instances on a thread pool. Every instance shares
+// one read-only Assets, copies one prefab library and has its own input script, so
+// nothing is shared while stepping.
+// With rendering on, every frame is also rendered into a list and submitted to a null
+// backend, so the render preparation is measured and its draw work counted. When
+// recording, the first instance renders to a recording backend instead so its last
+// frame can be written out and diffed against another run. Sounds always go through
+// a mixer of their own with a null device. After a run, check() compares what the
+// backends and devices were handed with what the scenes produced
+class Headless_Runner
+{
+	struct instance
+	{
+		std::shared_ptr<Scene_Play> scene;
+		Input_Script				script;
+		size_t						frames= 0;
+		double						seconds= 0;
+		Render_List					list;
+		std::shared_ptr<Render_Backend> backend;
+		std::shared_ptr<Audio_Mixer> audio;
+	};
+
+	const Assets		   &m_assets;
+	const Prefab_Library   &m_prefabs;
+	std::vector<instance>	m_instances;
+	Thread_Pool				m_pool;
+	double					m_wall_seconds= 0;
+	bool					m_render= false;
+	bool					m_record= false;
+
+public:
+
+	Headless_Runner(const Assets &assets, const Prefab_Library &prefabs, size_t threads);
+
+	void add_instance(const std::string &level_path, const Input_Script &script);
+	void set_render(bool render);
+	void set_record(bool record);
+	void run(size_t frames);
+	void report(std::ostream &out) const;
+	bool write_render(std::ostream &out) const;
+	bool check(std::ostream &out, bool same_input) const;
+};
@@ -0,0 +1,100 @@
+#include "Input_Capture.h"
+
+Input_Capture::~Input_Capture()
+{
+	stop();
+}
+
+void Input_Capture::start()
+{
+	if (m_running) { return; }
+
+	m_running= true;
+	m_thread= std::thread(&Input_Capture::capture, this);
+}
+
+void Input_Capture::stop()
+{
+	m_running= false;
+
+	if (m_thread.joinable())
+	{
+		m_thread.join();
+	}
+}
+
+// the window only knows its focus on the main thread, so it is passed in from there
+void Input_Capture::set_focus(bool focused)
+{
+	m_focused= focused;
+}
+
+bool Input_Capture::pop(input_event &event)
+{
+	return m_queue.pop(event);
+}
+
+size_t Input_Capture::dropped() const
+{
+	return m_queue.dropped();
+}
+
+// a press is seen up to one period after it happens, so the latencies measured from
+// these timestamps can be short by at most that much
+void Input_Capture::capture()
+{
+	bool down[sf::Keyboard::KeyCount]= {};
+	auto next= Input_Clock::now();
+
+	while (m_running)
+	{
+		auto now= Input_Clock::now();
+		bool focused= m_focused;
+
+		for (int key= 0; key < sf::Keyboard::KeyCount; key++)
+		{
+			// keys held when the window loses focus are released so nothing stays stuck down
+			bool pressed= focused && sf::Keyboard::isKeyPressed((sf::Keyboard::Key)key);
+
+			if (pressed != down[key])
+			{
+				down[key]= pressed;
+				m_queue.push({ key, pressed, now });
+			}
+		}
+
+		// after a stall, carry on from now instead of sampling in a burst to catch up.
+		// sf::sleep raises the timer resolution on Windows where a plain thread sleep
+		// rounds up to the 15.6 ms system tick, as the frame pacer's sleeps do
+		next= std::max(next + m_period, now);
+		sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(next - Input_Clock::now()).count()));
+	}
+}
+
+Latency_Stats::Latency_Stats(size_t capacity)
+	: m_samples(capacity) {}
+
+void Latency_Stats::record(Input_Clock::duration latency)
+{
+	m_samples[m_next]= std::chrono::duration<float, std::milli>(latency).count();
+	m_next= (m_next + 1) % m_samples.size();
+	m_count= std::min(m_count + 1, m_samples.size());
+}
+
+void Latency_Stats::report(std::ostream &out, const char *name) const
+{
+	out << name << ": ";
+	if (m_count == 0)
+	{
+		out << "no samples\n";
+		return;
+	}
+
+	std::vector<float> sorted(m_samples.begin(), m_samples.begin() + m_count);
+	std::sort(sorted.begin(), sorted.end());
+
+	auto percentile= [&](float p) { return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))]; };
+
+	out << m_count << " samples, p50 " << percentile(0.50f) << " ms, p90 " << percentile(0.90f)
+		<< " ms, p99 " << percentile(0.99f) << " ms, max " << sorted.back() << " ms\n";
+}
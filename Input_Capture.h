@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Common.h"
+#include "Spsc_Queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+typedef std::chrono::steady_clock Input_Clock;
+
+struct input_event
+{
+	int						key= 0;
+	bool					pressed= false;
+	Input_Clock::time_point time;
+};
+
+// Samples the keyboard on its own thread about once a millisecond and queues every
+// change with the time it was seen, so a key press is timestamped when it happens
+// rather than when the next frame gets around to polling window events
+class Input_Capture
+{
+	Spsc_Queue<input_event, 1024>	m_queue;
+	std::thread						m_thread;
+	std::atomic<bool>				m_running{ false };
+	std::atomic<bool>				m_focused{ true };
+	std::chrono::microseconds		m_period{ 1000 };
+
+	void capture();
+
+public:
+
+	~Input_Capture();
+
+	void start();
+	void stop();
+	void set_focus(bool focused);
+
+	bool   pop(input_event &event);
+	size_t dropped() const;
+};
+
+// A window of recent latency samples, reported as percentiles
+class Latency_Stats
+{
+	std::vector<float>	m_samples;		// milliseconds, overwritten oldest first once full
+	size_t				m_next= 0;
+	size_t				m_count= 0;
+
+public:
+
+	Latency_Stats(size_t capacity= 4096);
+
+	void record(Input_Clock::duration latency);
+	void report(std::ostream &out, const char *name) const;
+};
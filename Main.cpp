@@ -8,9 +8,235 @@
 #include <SFML/Graphics.hpp>
 
 #include "Game_Engine.h"
+#include "Headless_Runner.h"
+#include "Trace.h"
+#include "Frame_Pacer.h"
+#include "Audio_Mixer.h"
 
-int main()
+#include <random>
+#include <thread>
+
+// steps N windowless copies of a level in parallel and prints the throughput
+int run_bench(const std::string &level, size_t instances, size_t frames, size_t threads, bool render, const std::string &dump_path)
+{
+    Assets assets;
+    assets.load_from_file("assets.txt");
+    Prefab_Library prefabs;
+    prefabs.load_from_file("prefabs.txt", assets);
+
+    Headless_Runner runner(assets, prefabs, threads);
+    runner.set_render(render);
+    runner.set_record(!dump_path.empty());
+    for (size_t i= 0; i < instances; i++)
+    {
+        runner.add_instance(level, Input_Script::random((unsigned)i, frames));
+    }
+
+    runner.run(frames);
+    runner.report(std::cout);
+
+    if (!dump_path.empty())
+    {
+        std::ofstream out(dump_path);
+        if (!out || !runner.write_render(out))
+        {
+            std::cerr << "could not write the render dump to " << dump_path << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// steps two copies of a level on the same seeded input, the first rendering to a recording
+// backend and the second to a null one, both playing into null audio devices, and checks
+// that the render and audio backends were handed what the scenes produced
+int run_self_check(const std::string &level, size_t frames)
+{
+    Assets assets;
+    assets.load_from_file("assets.txt");
+    Prefab_Library prefabs;
+    prefabs.load_from_file("prefabs.txt", assets);
+
+    Headless_Runner runner(assets, prefabs, 2);
+    runner.set_record(true);
+    for (size_t i= 0; i < 2; i++)
+    {
+        runner.add_instance(level, Input_Script::random(0, frames));
+    }
+
+    runner.run(frames);
+    runner.report(std::cout);
+
+    if (!runner.check(std::cout, true))
+    {
+        std::cout << "self check failed\n";
+        return 1;
+    }
+    std::cout << "self check passed\n";
+    return 0;
+}
+
+// paces frames of made up work, 2 to 8 ms with the odd 25 ms spike, first the way
+// setFramerateLimit does and then with the hybrid pacer, and prints both distributions
+int run_pace_bench(size_t frames, unsigned rate)
+{
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> work_us(2000, 8000);
+    std::uniform_int_distribution<int> spike(0, 99);
+
+    for (e_Pacing pacing : { e_Pacing::Sleep, e_Pacing::Hybrid })
+    {
+        Frame_Pacer pacer(rate, pacing);
+        random.seed(7);
+
+        for (size_t i= 0; i <= frames; i++)
+        {
+            auto end= std::chrono::steady_clock::now() + std::chrono::microseconds(spike(random) == 0 ? 25000 : work_us(random));
+            while (std::chrono::steady_clock::now() < end) {}
+
+            pacer.wait();
+        }
+        pacer.report(std::cout);
+    }
+    return 0;
+}
+
+// plays bursts of random sounds, often more at once than there are voices, through a
+// mixer with a null device and prints what became of them and the cost of each
+int run_audio_bench(size_t frames)
 {
+    Assets assets;
+    assets.load_from_file("assets.txt");
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> sound(0, (int)e_Sound::Count - 1);
+    std::uniform_int_distribution<int> burst(0, 12);
+
+    std::vector<std::vector<e_Sound>> bursts(frames);
+    size_t requests= 0;
+    for (auto &frame : bursts)
+    {
+        for (int n= burst(random); n > 0; n--, requests++) { frame.push_back((e_Sound)sound(random)); }
+    }
+
+    Audio_Mixer mixer(assets, std::make_unique<Null_Audio_Device>(16));
+
+    auto start= std::chrono::steady_clock::now();
+    for (auto &frame : bursts)
+    {
+        for (e_Sound s : frame) { mixer.play(s); }
+        mixer.advance();
+    }
+    double seconds= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const audio_stats &stats= mixer.stats();
+    std::cout << requests << " sounds over " << frames << " frames on " << mixer.voices() << " voices: "
+        << stats.played << " played (" << stats.stolen << " on stolen voices), " << stats.merged << " merged, "
+        << stats.dropped << " dropped\n";
+    std::cout << (requests > 0 ? seconds * 1e9 / requests : 0) << " ns per sound\n";
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // debug builds only: --alloc-report prints every frame that allocates,
+    // --assert-no-alloc fails as soon as a steady-state frame allocates
+    bool alloc_report= false;
+    bool alloc_assert= false;
+
+    // --latency-report prints input latency percentiles when the game closes
+    bool latency_report= false;
+
+    // --fps N sets the frame rate (60 by default), --pace-report prints frame time
+    // and jitter percentiles when the game closes, and --pace-bench compares sleep
+    // pacing with hybrid pacing over --frames frames (600 by default) of simulated work
+    unsigned frame_rate= 60;
+    bool pace_report= false;
+    bool pace_bench= false;
+
+    // --audio-bench pushes --frames frames of random sound bursts through the mixer
+    bool audio_bench= false;
+
+    // --self-check steps --level for --frames frames (600 by default) headless, renders
+    // to a recording backend and plays into a null audio device, and exits non-zero when
+    // what they were handed does not match what the scene produced
+    bool self_check= false;
+
+    // --trace PATH captures a trace from startup, F9 stops it and writes PATH
+    // (trace.json when the game is started without it, F9 then starts a capture)
+    std::string trace_path;
+
+    // --bench-instances N runs N headless instances of --level for --frames
+    // frames on --threads threads instead of opening the game, --bench-render also
+    // renders every frame to a null backend and prints the draw work per frame,
+    // --render-dump PATH writes the first instance's last frame of render commands
+    // to PATH, the input is seeded so two runs of the same build give the same dump
+    size_t bench_instances= 0;
+    size_t bench_frames= 0;
+    size_t bench_threads= std::thread::hardware_concurrency();
+    std::string bench_level= "level1.txt";
+    bool bench_render= false;
+    std::string render_dump;
+
+    for (int i= 1; i < argc; i++)
+    {
+        std::string arg= argv[i];
+        bool has_value= i + 1 < argc;
+
+        if (arg == "--alloc-report")                      { alloc_report= true; }
+        else if (arg == "--assert-no-alloc")              { alloc_assert= true; }
+        else if (arg == "--latency-report")               { latency_report= true; }
+        else if (arg == "--trace" && has_value)           { trace_path= argv[++i]; }
+        else if (arg == "--fps" && has_value)             { frame_rate= std::stoul(argv[++i]); }
+        else if (arg == "--pace-report")                  { pace_report= true; }
+        else if (arg == "--pace-bench")                   { pace_bench= true; }
+        else if (arg == "--audio-bench")                  { audio_bench= true; }
+        else if (arg == "--self-check")                   { self_check= true; }
+        else if (arg == "--bench-instances" && has_value) { bench_instances= std::stoul(argv[++i]); }
+        else if (arg == "--frames" && has_value)          { bench_frames= std::stoul(argv[++i]); }
+        else if (arg == "--threads" && has_value)         { bench_threads= std::stoul(argv[++i]); }
+        else if (arg == "--level" && has_value)           { bench_level= argv[++i]; }
+        else if (arg == "--bench-render")                 { bench_render= true; }
+        else if (arg == "--render-dump" && has_value)     { render_dump= argv[++i]; }
+    }
+
+    if (bench_instances > 0)
+    {
+        return run_bench(bench_level, bench_instances, bench_frames ? bench_frames : 3600, bench_threads, bench_render, render_dump);
+    }
+
+    if (self_check)
+    {
+        return run_self_check(bench_level, bench_frames ? bench_frames : 600);
+    }
+
+    if (pace_bench)
+    {
+        return run_pace_bench(bench_frames ? bench_frames : 600, frame_rate);
+    }
+
+    if (audio_bench)
+    {
+        return run_audio_bench(bench_frames ? bench_frames : 36000);
+    }
+
+    Trace::name_thread("main");
+
+    // started before the engine so loading the assets is in the trace
+    if (!trace_path.empty())
+    {
+        Trace::start();
+    }
+
     Game_Engine g("assets.txt");
+    g.set_alloc_checks(alloc_report, alloc_assert);
+    g.set_latency_report(latency_report);
+    g.set_frame_rate(frame_rate);
+    g.set_pace_report(pace_report);
+    if (!trace_path.empty())
+    {
+        g.set_trace_path(trace_path);
+    }
+
     g.run();
 }
\ No newline at end of file
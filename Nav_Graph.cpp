@@ -0,0 +1,241 @@
+#include "Nav_Graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+// sizes the grid and reserves room for the most links the grid could ever have
+void Nav_Graph::reset(int columns, int rows, int jump_columns, int jump_rows)
+{
+	m_columns=		columns;
+	m_rows=			rows;
+	m_jump_columns= jump_columns;
+	m_jump_rows=	jump_rows;
+
+	size_t cells= (size_t)columns * rows;
+	size_t links_per_node= 4 + 2 * jump_columns * (2 * jump_rows + 1);
+
+	m_solid.assign(cells, 0);
+	m_out_start.assign(cells + 1, 0);
+	m_in_start.assign(cells + 1, 0);
+	m_links.clear();
+	m_in_links.clear();
+	m_links.reserve(cells * links_per_node);
+	m_in_links.reserve(cells * links_per_node);
+}
+
+void Nav_Graph::clear_solid()
+{
+	std::fill(m_solid.begin(), m_solid.end(), 0);
+}
+
+// marks a block of cells, clipped to the grid, rows count up from the bottom
+void Nav_Graph::set_solid(int column, int row, int columns, int rows)
+{
+	for (int r= std::max(row, 0); r < std::min(row + rows, m_rows); r++)
+	{
+		for (int c= std::max(column, 0); c < std::min(column + columns, m_columns); c++)
+		{
+			m_solid[cell(c, r)]= 1;
+		}
+	}
+}
+
+// the level's left and right edges are walls, above and below it is open air
+bool Nav_Graph::is_solid(int column, int row) const
+{
+	if (column < 0 || column >= m_columns) { return true; }
+	if (row < 0 || row >= m_rows)		   { return false; }
+	return m_solid[cell(column, row)] != 0;
+}
+
+bool Nav_Graph::is_node(int column, int row) const
+{
+	return column >= 0 && column < m_columns && row >= 0 && row < m_rows
+		&& !is_solid(column, row) && is_solid(column, row - 1);
+}
+
+// the node at a cell, or the first one straight below it, -1 when it is over a hole
+int Nav_Graph::find_node(int column, int row) const
+{
+	if (column < 0 || column >= m_columns) { return -1; }
+
+	for (int r= std::min(row, m_rows - 1); r >= 0; r--)
+	{
+		if (is_solid(column, r)) { return -1; }
+		if (is_node(column, r))	 { return cell(column, r); }
+	}
+	return -1;
+}
+
+bool Nav_Graph::clear_column(int column, int bottom, int top) const
+{
+	for (int r= bottom; r <= top; r++)
+	{
+		if (is_solid(column, r)) { return false; }
+	}
+	return true;
+}
+
+bool Nav_Graph::clear_row(int row, int first, int last) const
+{
+	for (int c= std::min(first, last); c <= std::max(first, last); c++)
+	{
+		if (is_solid(c, row)) { return false; }
+	}
+	return true;
+}
+
+void Nav_Graph::add_links(int column, int row)
+{
+	uint32_t from= cell(column, row);
+
+	for (int direction= -1; direction <= 1; direction+= 2)
+	{
+		int next= column + direction;
+
+		// walk onto the neighbouring node, or step off the edge and fall to the first node below
+		if (is_node(next, row))
+		{
+			m_links.push_back({ from, (uint32_t)cell(next, row), 2, e_Nav_Link::Walk });
+		}
+		else if (!is_solid(next, row))
+		{
+			int landing= find_node(next, row - 1);
+			if (landing >= 0)
+			{
+				m_links.push_back({ from, (uint32_t)landing, (uint16_t)(2 + row - this->row(landing)), e_Nav_Link::Drop });
+			}
+		}
+
+		// a jump is checked against a box shaped arc: straight up to the higher of the two
+		// rows, across, then straight down onto the landing node
+		for (int dx= 1; dx <= m_jump_columns; dx++)
+		{
+			int to_column= column + direction * dx;
+
+			for (int dy= m_jump_rows; dy >= -m_jump_rows; dy--)
+			{
+				int to_row= row + dy;
+
+				// one cell over at the same height or lower is a walk or a drop
+				if (dx == 1 && dy <= 0) { continue; }
+				if (!is_node(to_column, to_row)) { continue; }
+
+				int top= std::max(row, to_row);
+				if (!clear_column(column, row, top) || !clear_row(top, column + direction, to_column)
+					|| !clear_column(to_column, to_row, top))
+				{
+					continue;
+				}
+
+				m_links.push_back({ from, (uint32_t)cell(to_column, to_row), (uint16_t)(4 + dx + std::abs(dy)), e_Nav_Link::Jump });
+			}
+		}
+	}
+}
+
+// regenerates every link from the solid cells, then indexes them by the cell they arrive at
+void Nav_Graph::build()
+{
+	m_links.clear();
+
+	for (int r= 0; r < m_rows; r++)
+	{
+		for (int c= 0; c < m_columns; c++)
+		{
+			m_out_start[cell(c, r)]= (uint32_t)m_links.size();
+			if (is_node(c, r)) { add_links(c, r); }
+		}
+	}
+	m_out_start[cells()]= (uint32_t)m_links.size();
+
+	// a counting sort by destination, m_in_start ends up holding where each cell's list begins
+	std::fill(m_in_start.begin(), m_in_start.end(), 0);
+	for (auto &l : m_links)
+	{
+		m_in_start[l.to + 1]++;
+	}
+	for (size_t i= 1; i < m_in_start.size(); i++)
+	{
+		m_in_start[i]+= m_in_start[i - 1];
+	}
+
+	m_in_links.resize(m_links.size());
+	for (uint32_t i= 0; i < m_links.size(); i++)
+	{
+		m_in_links[m_in_start[m_links[i].to]++]= i;
+	}
+	for (size_t i= m_in_start.size() - 1; i > 0; i--)
+	{
+		m_in_start[i]= m_in_start[i - 1];
+	}
+	m_in_start[0]= 0;
+
+	m_version++;
+}
+
+void Flow_Field::reset(const Nav_Graph &graph)
+{
+	m_cost.assign(graph.cells(), UNREACHABLE);
+	m_open.clear();
+	m_open.reserve(graph.max_links() + 1);
+	m_target= -1;
+	m_version= 0;
+}
+
+// Dijkstra from the target along links taken backwards. Each node is pushed at most
+// once per link into it, the open list is rebuilt in place and sized for that, so the
+// search never allocates
+void Flow_Field::update(const Nav_Graph &graph, int target)
+{
+	if (target == m_target && graph.version() == m_version) { return; }
+
+	m_target=  target;
+	m_version= graph.version();
+	std::fill(m_cost.begin(), m_cost.end(), UNREACHABLE);
+
+	if (target < 0) { return; }
+
+	m_open.clear();
+	m_cost[target]= 0;
+	m_open.push_back({ 0, (uint32_t)target });
+
+	while (!m_open.empty())
+	{
+		std::pop_heap(m_open.begin(), m_open.end());
+		open_node node= m_open.back();
+		m_open.pop_back();
+
+		if (node.cost > m_cost[node.cell]) { continue; }
+
+		for (const uint32_t *i= graph.in_links_begin(node.cell); i != graph.in_links_end(node.cell); i++)
+		{
+			const Nav_Graph::link &l= graph.get_link(*i);
+			uint32_t cost= node.cost + l.cost;
+
+			if (cost < m_cost[l.from])
+			{
+				m_cost[l.from]= cost;
+				m_open.push_back({ cost, l.from });
+				std::push_heap(m_open.begin(), m_open.end());
+			}
+		}
+	}
+}
+
+// the cheapest link out of a node toward the target, nullptr at the target or when it can't be reached
+const Nav_Graph::link *Flow_Field::next(const Nav_Graph &graph, int cell) const
+{
+	const Nav_Graph::link *best= nullptr;
+	uint32_t best_cost= m_cost[cell];
+
+	for (const Nav_Graph::link *l= graph.links_begin(cell); l != graph.links_end(cell); l++)
+	{
+		if (m_cost[l->to] != UNREACHABLE && m_cost[l->to] + l->cost <= best_cost)
+		{
+			best= l;
+			best_cost= m_cost[l->to] + l->cost;
+		}
+	}
+	return best;
+}
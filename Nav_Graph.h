@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class e_Nav_Link : uint8_t { Walk, Drop, Jump };
+
+// Where an enemy standing on the tile grid can get to. A node is an empty cell with a
+// solid cell under it, links join nodes an enemy can walk, drop or jump between. The
+// graph is built once per level and rebuilt only when the tiles change, into storage
+// reserved up front so rebuilding never allocates
+class Nav_Graph
+{
+public:
+
+	struct link
+	{
+		uint32_t	from= 0;
+		uint32_t	to=   0;
+		uint16_t	cost= 0;
+		e_Nav_Link	type= e_Nav_Link::Walk;
+	};
+
+private:
+
+	int						m_columns=		0;
+	int						m_rows=			0;
+	int						m_jump_columns= 0;	// how far a jump can carry, in cells
+	int						m_jump_rows=	0;
+	size_t					m_version=		0;	// bumped on every build so flow fields know to refresh
+	std::vector<uint8_t>	m_solid;
+	std::vector<link>		m_links;			// grouped by the cell they leave from
+	std::vector<uint32_t>	m_out_start;		// first link leaving each cell, plus one past the end
+	std::vector<uint32_t>	m_in_links;			// link indices grouped by the cell they arrive at
+	std::vector<uint32_t>	m_in_start;
+
+	void add_links(int column, int row);
+	bool clear_column(int column, int bottom, int top) const;
+	bool clear_row(int row, int first, int last) const;
+
+public:
+
+	void reset(int columns, int rows, int jump_columns, int jump_rows);
+	void clear_solid();
+	void set_solid(int column, int row, int columns, int rows);
+	void build();
+
+	bool is_solid(int column, int row) const;
+	bool is_node(int column, int row) const;
+	int  find_node(int column, int row) const;
+
+	int    cell(int column, int row) const { return row * m_columns + column; }
+	int    column(int cell)			 const { return cell % m_columns; }
+	int    row(int cell)			 const { return cell / m_columns; }
+	size_t cells()					 const { return m_solid.size(); }
+	size_t max_links()				 const { return m_links.capacity(); }
+	size_t version()				 const { return m_version; }
+	bool   empty()					 const { return m_links.empty(); }
+
+	const link	   *links_begin(int cell)	 const { return m_links.data() + m_out_start[cell]; }
+	const link	   *links_end(int cell)		 const { return m_links.data() + m_out_start[cell + 1]; }
+	const uint32_t *in_links_begin(int cell) const { return m_in_links.data() + m_in_start[cell]; }
+	const uint32_t *in_links_end(int cell)	 const { return m_in_links.data() + m_in_start[cell + 1]; }
+	const link	   &get_link(uint32_t index) const { return m_links[index]; }
+};
+
+// Cost from every node to one target node, found by searching the graph backwards from
+// the target. It only recomputes when the target or the graph changes, so any number of
+// enemies can follow it for one lookup each per frame
+class Flow_Field
+{
+	struct open_node
+	{
+		uint32_t cost= 0;
+		uint32_t cell= 0;
+
+		bool operator<(const open_node &rhs) const { return cost > rhs.cost; }
+	};
+
+	std::vector<uint32_t>	m_cost;
+	std::vector<open_node>	m_open;
+	int						m_target=  -1;
+	size_t					m_version= 0;
+
+public:
+
+	static constexpr uint32_t UNREACHABLE= UINT32_MAX;
+
+	void reset(const Nav_Graph &graph);
+	void update(const Nav_Graph &graph, int target);
+
+	uint32_t			   cost(int cell) const { return m_cost[cell]; }
+	int					   target()		  const { return m_target; }
+	const Nav_Graph::link *next(const Nav_Graph &graph, int cell) const;
+};
@@ -0,0 +1,149 @@
+#include "Particle_System.h"
+#include "Assets.h"
+#include "Render_List.h"
+
+Particle_System::Particle_System(const Assets &assets, size_t capacity)
+	: m_atlas(&assets.get_atlas(e_Atlas::Particles))
+	, m_capacity(capacity)
+	, m_x(capacity), m_y(capacity)
+	, m_velocity_x(capacity), m_velocity_y(capacity), m_gravity(capacity)
+	, m_start(capacity), m_end(capacity)
+	, m_effect(capacity), m_frame(capacity)
+{
+	auto set_effect= [&](e_Effect kind, e_Animation id)
+	{
+		const auto &frames= m_atlas->frames[(size_t)id];
+		const Animation &animation= assets.get_animation(id);
+		m_effects[(size_t)kind]= { frames.data(), frames.size(), animation.get_speed() };
+	};
+
+	set_effect(e_Effect::Explosion, e_Animation::Explosion);
+	set_effect(e_Effect::Coin, e_Animation::Coin);
+	set_effect(e_Effect::Squash, e_Animation::GoombaSquash);
+
+	// debris is a brick cut in four, each piece is a frame that is picked at spawn and never advances
+	sf::IntRect brick= m_atlas->frames[(size_t)e_Animation::Brick][0];
+	int half_width= brick.width / 2;
+	int half_height= brick.height / 2;
+	for (int i= 0; i < 4; i++)
+	{
+		m_debris_frames[i]= sf::IntRect(brick.left + (i % 2) * half_width, brick.top + (i / 2) * half_height, half_width, half_height);
+	}
+	m_effects[(size_t)e_Effect::Debris]= { m_debris_frames.data(), m_debris_frames.size(), 0 };
+}
+
+// a lifetime of 0 lasts exactly one play through of the effect's animation
+void Particle_System::spawn(e_Effect kind, const c_Vec2 &position, const c_Vec2 &velocity, float gravity, size_t now, size_t lifetime, uint8_t frame)
+{
+	if (m_count == m_capacity)
+	{
+		m_dropped++;
+		return;
+	}
+
+	const effect &e= m_effects[(size_t)kind];
+	if (lifetime == 0) { lifetime= e.speed * e.frame_count; }
+
+	size_t i= m_count++;
+	m_x[i]=			 position.x;
+	m_y[i]=			 position.y;
+	m_velocity_x[i]= velocity.x;
+	m_velocity_y[i]= velocity.y;
+	m_gravity[i]=	 gravity;
+	m_start[i]=		 (uint32_t)now;
+	m_end[i]=		 (uint32_t)(now + lifetime);
+	m_effect[i]=	 (uint8_t)kind;
+	m_frame[i]=		 frame;
+}
+
+// four brick quarters thrown up and out from where the brick was
+void Particle_System::spawn_debris(const c_Vec2 &position, size_t now)
+{
+	const float speed_x[4]= { -3.0f, 3.0f, -2.0f, 2.0f };
+	const float speed_y[4]= { -12.0f, -12.0f, -8.0f, -8.0f };
+
+	for (uint8_t i= 0; i < 4; i++)
+	{
+		c_Vec2 offset((i % 2) ? 16.0f : -16.0f, (i / 2) ? 16.0f : -16.0f);
+		spawn(e_Effect::Debris, position + offset, c_Vec2(speed_x[i], speed_y[i]), 0.75f, now, 60, i);
+	}
+}
+
+// moves every particle then packs the live ones to the front. The movement loops have
+// no branches and touch only float arrays, so the compiler can vectorize them
+void Particle_System::update(size_t now)
+{
+	size_t count= m_count;
+	float *x= m_x.data();
+	float *y= m_y.data();
+	float *velocity_x= m_velocity_x.data();
+	float *velocity_y= m_velocity_y.data();
+	const float *gravity= m_gravity.data();
+
+	for (size_t i= 0; i < count; i++)
+	{
+		velocity_y[i]+= gravity[i];
+	}
+	for (size_t i= 0; i < count; i++)
+	{
+		x[i]+= velocity_x[i];
+		y[i]+= velocity_y[i];
+	}
+
+	size_t live= 0;
+	for (size_t i= 0; i < count; i++)
+	{
+		if (m_end[i] <= now) { continue; }
+
+		if (live != i)
+		{
+			m_x[live]=			m_x[i];
+			m_y[live]=			m_y[i];
+			m_velocity_x[live]= m_velocity_x[i];
+			m_velocity_y[live]= m_velocity_y[i];
+			m_gravity[live]=	m_gravity[i];
+			m_start[live]=		m_start[i];
+			m_end[live]=		m_end[i];
+			m_effect[live]=		m_effect[i];
+			m_frame[live]=		m_frame[i];
+		}
+		live++;
+	}
+	m_count= live;
+}
+
+void Particle_System::clear()
+{
+	m_count= 0;
+}
+
+// adds a sprite per visible particle, they all share the atlas so they draw in one call
+void Particle_System::draw(Render_List &list, size_t now, float view_left, float view_right)
+{
+	for (size_t i= 0; i < m_count; i++)
+	{
+		const effect &e= m_effects[m_effect[i]];
+		size_t effect_frame= m_frame[i];
+		if (e.speed > 0)
+		{
+			effect_frame+= (now - m_start[i]) / e.speed;
+		}
+		const sf::IntRect &rect= e.frames[effect_frame % e.frame_count];
+
+		float half_width= rect.width / 2.0f;
+		float half_height= rect.height / 2.0f;
+		if (m_x[i] + half_width < view_left || m_x[i] - half_width > view_right) { continue; }
+
+		list.sprite(e_Layer::Effects, &m_atlas->texture, rect, sf::Vector2f(half_width, half_height), sf::Vector2f(m_x[i], m_y[i]));
+	}
+}
+
+size_t Particle_System::size() const
+{
+	return m_count;
+}
+
+size_t Particle_System::dropped() const
+{
+	return m_dropped;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Common.h"
+
+#include <array>
+#include <cstdint>
+
+class Assets;
+class Render_List;
+struct Texture_Atlas;
+
+enum class e_Effect : uint8_t { Explosion, Coin, Debris, Squash, Count };
+
+// Short lived visual effects kept out of the entity manager. Particles live in a fixed
+// capacity structure of arrays, are updated with plain loops over those arrays and are
+// all drawn from one texture atlas in a single call
+class Particle_System
+{
+	struct effect
+	{
+		const sf::IntRect  *frames= nullptr;	// atlas rects
+		size_t				frame_count= 1;
+		size_t				speed= 0;			// animation frames per frame of the effect, 0 for still
+	};
+
+	const Texture_Atlas				   *m_atlas= nullptr;
+	std::array<effect, (size_t)e_Effect::Count> m_effects;
+	std::array<sf::IntRect, 4>			m_debris_frames;		// the four quarters of a brick
+
+	size_t								m_capacity= 0;
+	size_t								m_count= 0;
+	size_t								m_dropped= 0;
+	std::vector<float>					m_x;
+	std::vector<float>					m_y;
+	std::vector<float>					m_velocity_x;
+	std::vector<float>					m_velocity_y;
+	std::vector<float>					m_gravity;
+	std::vector<uint32_t>				m_start;				// animation frame the particle was spawned on
+	std::vector<uint32_t>				m_end;					// first animation frame it is gone on
+	std::vector<uint8_t>				m_effect;
+	std::vector<uint8_t>				m_frame;				// first frame of the effect to show
+
+public:
+
+	Particle_System(const Assets &assets, size_t capacity= 1024);
+
+	void spawn(e_Effect kind, const c_Vec2 &position, const c_Vec2 &velocity, float gravity,
+			   size_t now, size_t lifetime= 0, uint8_t frame= 0);
+	void spawn_debris(const c_Vec2 &position, size_t now);
+	void update(size_t now);
+	void clear();
+	void draw(Render_List &list, size_t now, float view_left, float view_right);
+
+	size_t size() const;
+	size_t dropped() const;
+};
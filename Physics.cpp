@@ -5,7 +5,7 @@ c_Vec2 Physics::get_overlap(std::shared_ptr<Entity> a, std::shared_ptr<Entity> b
 {
 	c_Vec2 overlap= c_Vec2(0, 0);
 
-	if (a->get_component<c_Bounding_box>().has && b->get_component<c_Bounding_box>().has)
+	if (a->has_component<c_Bounding_box>() && b->has_component<c_Bounding_box>())
 	{
 		c_Vec2 a_position= a->get_component<c_Transform>().position;
 		c_Vec2 b_position= b->get_component<c_Transform>().position;
@@ -28,7 +28,7 @@ c_Vec2 Physics::get_previous_overlap(std::shared_ptr<Entity> a, std::shared_ptr<
 {
 	c_Vec2 overlap= c_Vec2(0, 0);
 
-	if (a->get_component<c_Bounding_box>().has && b->get_component<c_Bounding_box>().has)
+	if (a->has_component<c_Bounding_box>() && b->has_component<c_Bounding_box>())
 	{
 		c_Vec2 a_position= a->get_component<c_Transform>().previous_position;
 		c_Vec2 b_position= b->get_component<c_Transform>().previous_position;
@@ -45,4 +45,40 @@ c_Vec2 Physics::get_previous_overlap(std::shared_ptr<Entity> a, std::shared_ptr<
 	}
 
 	return overlap;
+}
+
+// the same tests against a static box, such as a merged tile collider
+c_Vec2 Physics::get_overlap(std::shared_ptr<Entity> a, const c_Vec2 &b_position, const c_Vec2 &b_half_size)
+{
+	c_Vec2 a_position= a->get_component<c_Transform>().position;
+	c_Vec2 a_half_size= a->get_component<c_Bounding_box>().half_size;
+
+	c_Vec2 delta= c_Vec2(abs(a_position.x - b_position.x), abs(a_position.y - b_position.y));
+
+	return c_Vec2(a_half_size.x + b_half_size.x - delta.x, a_half_size.y + b_half_size.y - delta.y);
+}
+
+c_Vec2 Physics::get_previous_overlap(std::shared_ptr<Entity> a, const c_Vec2 &b_position, const c_Vec2 &b_half_size)
+{
+	c_Vec2 a_position= a->get_component<c_Transform>().previous_position;
+	c_Vec2 a_half_size= a->get_component<c_Bounding_box>().half_size;
+
+	c_Vec2 delta= c_Vec2(abs(a_position.x - b_position.x), abs(a_position.y - b_position.y));
+
+	return c_Vec2(a_half_size.x + b_half_size.x - delta.x, a_half_size.y + b_half_size.y - delta.y);
+}
+
+// an entity that was already inside a box last frame is pushed out on both axes, as it
+// would be by a single tile, except along an axis where the box is deeper than any
+// single tile could be, an entity embedded in a long merged collider is not pushed across it
+c_Vec2 Physics::limit_push(const c_Vec2 &overlap, const c_Vec2 &previous_overlap, const c_Vec2 &max_overlap)
+{
+	if (previous_overlap.x <= 0 || previous_overlap.y <= 0) { return previous_overlap; }
+
+	bool too_wide= overlap.x > max_overlap.x;
+	bool too_tall= overlap.y > max_overlap.y;
+	if (too_wide && too_tall) { too_wide= overlap.x > overlap.y; too_tall= !too_wide; }
+
+	// a horizontal push needs a previous vertical overlap and the other way round
+	return c_Vec2(too_tall ? 0 : previous_overlap.x, too_wide ? 0 : previous_overlap.y);
 }
\ No newline at end of file
@@ -7,4 +7,7 @@ namespace Physics
 {
 	c_Vec2 get_overlap(std::shared_ptr<Entity> a, std::shared_ptr <Entity> b);
 	c_Vec2 get_previous_overlap(std::shared_ptr<Entity> a, std::shared_ptr<Entity> b);
+	c_Vec2 get_overlap(std::shared_ptr<Entity> a, const c_Vec2 &b_position, const c_Vec2 &b_half_size);
+	c_Vec2 get_previous_overlap(std::shared_ptr<Entity> a, const c_Vec2 &b_position, const c_Vec2 &b_half_size);
+	c_Vec2 limit_push(const c_Vec2 &overlap, const c_Vec2 &previous_overlap, const c_Vec2 &max_overlap);
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "Pool_Allocator.h"
+
+#include <cstddef>
+#include <algorithm>
+
+Block_Pool::Block_Pool(size_t chunk_blocks, std::pmr::memory_resource *resource)
+	: m_resource(resource)
+	, m_chunk_blocks(chunk_blocks)
+	, m_chunks(resource) {}
+
+Block_Pool::~Block_Pool()
+{
+	for (char *chunk : m_chunks)
+	{
+		m_resource->deallocate(chunk, m_block_size * m_chunk_blocks, alignof(std::max_align_t));
+	}
+}
+
+// threads every block of a new chunk onto the free list
+void Block_Pool::add_chunk()
+{
+	char *chunk= static_cast<char *>(m_resource->allocate(m_block_size * m_chunk_blocks, alignof(std::max_align_t)));
+	m_chunks.push_back(chunk);
+	m_capacity+= m_chunk_blocks;
+
+	for (size_t i= 0; i < m_chunk_blocks; i++)
+	{
+		void *block= chunk + i * m_block_size;
+		*static_cast<void **>(block)= m_free;
+		m_free= block;
+	}
+}
+
+void *Block_Pool::allocate(size_t size)
+{
+	// the first allocation decides the block size, a pool only ever holds one type
+	if (m_block_size == 0)
+	{
+		const size_t align= alignof(std::max_align_t);
+		m_block_size= (std::max(size, sizeof(void *)) + align - 1) / align * align;
+		reserve(m_reserved);
+	}
+	assert(size <= m_block_size);
+
+	if (!m_free)
+	{
+		add_chunk();
+	}
+
+	void *block= m_free;
+	m_free= *static_cast<void **>(block);
+	return block;
+}
+
+void Block_Pool::deallocate(void *block)
+{
+	*static_cast<void **>(block)= m_free;
+	m_free= block;
+}
+
+// makes sure at least this many blocks exist in total, the block size is only known
+// after the first allocation so a reserve made before then is applied at that point
+void Block_Pool::reserve(size_t blocks)
+{
+	m_reserved= std::max(m_reserved, blocks);
+
+	if (m_block_size == 0) { return; }
+
+	m_chunks.reserve(m_reserved / m_chunk_blocks + 1);
+	while (m_capacity < m_reserved)
+	{
+		add_chunk();
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <cassert>
+
+// Hands out fixed size blocks carved from larger chunks. Freed blocks go on a free
+// list and are handed out again, so churn such as bullets never returns to the heap.
+// The chunks themselves come from a memory resource, such as a scene's level arena
+class Block_Pool
+{
+	std::pmr::memory_resource  *m_resource;
+	size_t						m_block_size=	0;
+	size_t						m_chunk_blocks= 0;
+	size_t						m_capacity=		0;
+	size_t						m_reserved=		0;
+	std::pmr::vector<char *>	m_chunks;
+	void					   *m_free=			nullptr;
+
+	void add_chunk();
+
+public:
+
+	Block_Pool(size_t chunk_blocks= 256, std::pmr::memory_resource *resource= std::pmr::get_default_resource());
+	~Block_Pool();
+
+	Block_Pool(const Block_Pool &)= delete;
+	Block_Pool &operator=(const Block_Pool &)= delete;
+
+	void *allocate(size_t size);
+	void  deallocate(void *block);
+	void  reserve(size_t blocks);
+};
+
+// Allocator for std::allocate_shared that puts the object and its control block in a
+// Block_Pool. Every copy shares the pool, so the pool lives as long as any object in it
+template <typename T>
+class Pool_Allocator
+{
+public:
+
+	typedef T value_type;
+
+	std::shared_ptr<Block_Pool> pool;
+
+	Pool_Allocator(std::shared_ptr<Block_Pool> p)
+		: pool(std::move(p)) {}
+
+	template <typename U>
+	Pool_Allocator(const Pool_Allocator<U> &other)
+		: pool(other.pool) {}
+
+	T *allocate(size_t n)
+	{
+		assert(n == 1);
+		return static_cast<T *>(pool->allocate(sizeof(T)));
+	}
+
+	void deallocate(T *block, size_t)
+	{
+		pool->deallocate(block);
+	}
+
+	// constructs through the allocator so classes with private constructors can befriend it
+	template <typename U, typename... T_args>
+	void construct(U *block, T_args&&... args)
+	{
+		::new((void *)block) U(std::forward<T_args>(args)...);
+	}
+
+	template <typename U>
+	void destroy(U *block)
+	{
+		block->~U();
+	}
+
+	template <typename U>
+	bool operator==(const Pool_Allocator<U> &rhs) const { return pool == rhs.pool; }
+
+	template <typename U>
+	bool operator!=(const Pool_Allocator<U> &rhs) const { return pool != rhs.pool; }
+};
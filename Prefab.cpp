@@ -0,0 +1,185 @@
+#include "Prefab.h"
+#include "Assets.h"
+
+#include <cassert>
+
+namespace
+{
+	const char *const TAG_NAMES[]=	 { "Default", "Player", "Enemy", "Bullet", "Tile", "Dec" };
+	const char *const STATE_NAMES[]= { "Standing", "Ground", "Air", "Bouncing" };
+
+	template <typename T, size_t N>
+	bool find_name(const char *const (&names)[N], const std::string &name, T &value)
+	{
+		for (size_t i= 0; i < N; i++)
+		{
+			if (name == names[i])
+			{
+				value= (T)i;
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+// a prefab is a block of lines from "Prefab N T" to "End", one line per component.
+// "Base N" starts it as a copy of an earlier prefab, the lines after it add to or
+// override what that one has
+void Prefab_Library::load_from_file(const std::string &path, const Assets &assets)
+{
+	m_prefabs.clear();
+
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cerr << "Could not load prefabs file: " << path << std::endl;
+		return;
+	}
+
+	std::string string;
+	Prefab prefab;
+	bool open= false;
+
+	while (file >> string)
+	{
+		if (string == "Prefab")
+		{
+			std::string tag;
+			prefab= Prefab();
+			file >> prefab.name >> tag;
+
+			if (!find_name(TAG_NAMES, tag, prefab.tag))
+			{
+				std::cerr << "Unknown tag " << tag << " for prefab " << prefab.name << std::endl;
+			}
+			prefab.add<c_Transform>();
+			open= true;
+		}
+		else if (!open)
+		{
+			std::cerr << "Prefab line outside a prefab: " << string << std::endl;
+		}
+		else if (string == "End")
+		{
+			if (id(prefab.name) >= 0)
+			{
+				std::cerr << "Prefab " << prefab.name << " is declared twice" << std::endl;
+			}
+			m_prefabs.push_back(prefab);
+			open= false;
+		}
+		else if (string == "Base")
+		{
+			file >> string;
+
+			int base= id(string);
+			if (base < 0)
+			{
+				std::cerr << "Unknown base prefab " << string << " for " << prefab.name << std::endl;
+				continue;
+			}
+
+			Prefab copy= m_prefabs[base];
+			copy.name= prefab.name;
+			copy.tag= prefab.tag;
+			copy.base= base;
+			prefab= copy;
+		}
+		else if (string == "Animation")
+		{
+			std::string name;
+			int repeat;
+			file >> name >> repeat;
+
+			e_Animation animation= Assets::animation_id(name);
+			if (animation == e_Animation::Count)
+			{
+				std::cerr << "Unknown animation " << name << " for prefab " << prefab.name << std::endl;
+				continue;
+			}
+			prefab.add<c_Animation>(assets.get_animation(animation), repeat != 0, 0);
+		}
+		else if (string == "Velocity")
+		{
+			file >> prefab.get<c_Transform>().velocity.x >> prefab.get<c_Transform>().velocity.y;
+		}
+		else if (string == "Box")
+		{
+			c_Vec2 size;
+			file >> size.x >> size.y;
+			prefab.add<c_Bounding_box>(size);
+		}
+		else if (string == "Gravity")
+		{
+			float gravity;
+			file >> gravity;
+			prefab.add<c_Gravity>(gravity);
+		}
+		else if (string == "State")
+		{
+			e_State state= e_State::Air;
+			file >> string;
+
+			if (!find_name(STATE_NAMES, string, state))
+			{
+				std::cerr << "Unknown state " << string << " for prefab " << prefab.name << std::endl;
+			}
+			prefab.add<c_State>(state);
+		}
+		else if (string == "Lifespan")
+		{
+			int frames;
+			file >> frames;
+			prefab.add<c_Lifespan>(frames, 0);
+		}
+		else if (string == "Input")		{ prefab.add<c_Input>(); }
+		else if (string == "Pathing")	{ prefab.add<c_Pathing>(); }
+		else if (string == "Sleep")		{ prefab.asleep= true; }
+		else
+		{
+			std::cerr << "Unknown prefab line: " << string << std::endl;
+		}
+	}
+
+	if (open)
+	{
+		std::cerr << "Prefab " << prefab.name << " has no End" << std::endl;
+	}
+}
+
+// a linear scan, only ever done while reading a data file
+int Prefab_Library::id(const std::string &name) const
+{
+	for (size_t i= 0; i < m_prefabs.size(); i++)
+	{
+		if (m_prefabs[i].name == name) { return (int)i; }
+	}
+	return -1;
+}
+
+bool Prefab_Library::derives(int id, int base) const
+{
+	for (; id >= 0; id= m_prefabs[id].base)
+	{
+		if (id == base) { return true; }
+	}
+	return false;
+}
+
+size_t Prefab_Library::size() const
+{
+	return m_prefabs.size();
+}
+
+const Prefab &Prefab_Library::get(int id) const
+{
+	assert(id >= 0 && id < (int)m_prefabs.size());
+	return m_prefabs[id];
+}
+
+Prefab &Prefab_Library::get(int id)
+{
+	assert(id >= 0 && id < (int)m_prefabs.size());
+	return m_prefabs[id];
+}
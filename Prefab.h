@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Common.h"
+#include "Entity.h"
+
+#include <string>
+
+class Assets;
+
+// An entity built ahead of time from the prefabs file: its tag and every one of its
+// components already constructed, so spawning one is a single copy of the block
+// instead of a run of add_component calls. Every prefab has a transform, the spawner
+// places it and starts its animation
+struct Prefab
+{
+	std::string		name;
+	e_Tag			tag= e_Tag::Default;
+	uint32_t		signature= 0;
+	ComponentTuple	components;
+	bool			asleep= false;		// spawned asleep, for enemies woken as the view nears
+	int				base= -1;			// the prefab it was built on, -1 for none
+
+	template <typename T, typename... T_args>
+	T &add(T_args&&... args)
+	{
+		auto &component= std::get<T>(components);
+		component= T(std::forward<T_args>(args)...);
+		component.has= true;
+		signature|= signature_of<T>();
+		return component;
+	}
+
+	template <typename T>
+	bool has() const
+	{
+		return (signature & signature_of<T>()) != 0;
+	}
+
+	template <typename T>
+	T &get()
+	{
+		return std::get<T>(components);
+	}
+
+	template <typename T>
+	const T &get() const
+	{
+		return std::get<T>(components);
+	}
+};
+
+// Every prefab read from a prefabs file. Names are only looked up while reading data
+// files, after that a prefab is referred to by its index
+class Prefab_Library
+{
+	std::vector<Prefab> m_prefabs;
+
+public:
+
+	void load_from_file(const std::string &path, const Assets &assets);
+
+	int	 id(const std::string &name) const;			// -1 when there is none
+	bool derives(int id, int base) const;			// is base, or built on it
+	size_t size() const;
+
+	const Prefab &get(int id) const;
+	Prefab		 &get(int id);
+};
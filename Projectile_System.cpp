@@ -0,0 +1,272 @@
+#include "Projectile_System.h"
+#include "Animation.h"
+#include "Render_List.h"
+#include "Snapshot.h"
+
+#include <cmath>
+
+namespace
+{
+	const weapon_config WEAPONS[(size_t)e_Weapon::Count]=
+	{
+		//	cooldown	shots	spread	speed	pierce	lifespan
+		{	0,			1,		0,		10,		1,		180 },		// Buster
+		{	6,			1,		0,		12,		1,		90	},		// Rapid, keeps firing while held
+		{	0,			5,		12,		10,		1,		60	},		// Spread
+		{	0,			1,		0,		14,		4,		180 },		// Pierce
+	};
+}
+
+Projectile_System::Projectile_System(size_t capacity)
+	: m_capacity(capacity)
+	, m_x(capacity), m_y(capacity)
+	, m_velocity_x(capacity), m_velocity_y(capacity)
+	, m_end(capacity), m_hits(capacity)
+{
+	m_targets.reserve(1024);
+	m_buckets.reserve(2048);
+	m_column_start.reserve(1024);
+}
+
+const weapon_config &Projectile_System::weapon(e_Weapon weapon)
+{
+	return WEAPONS[(size_t)weapon];
+}
+
+e_Weapon Projectile_System::weapon_id(const std::string &name)
+{
+	for (size_t i= 0; WEAPON_NAMES[i] != nullptr; i++)
+	{
+		if (name == WEAPON_NAMES[i]) { return (e_Weapon)i; }
+	}
+	return e_Weapon::Count;
+}
+
+// the most hits any weapon's shot can make
+uint8_t Projectile_System::max_pierce()
+{
+	uint8_t pierce= 0;
+	for (const weapon_config &config : WEAPONS)
+	{
+		pierce= std::max(pierce, config.pierce);
+	}
+	return pierce;
+}
+
+// every shot is drawn, and hits, with the first frame of the weapon's animation
+void Projectile_System::set_sprite(const Animation &animation)
+{
+	m_texture=	 animation.get_texture();
+	m_rect=		 animation.get_frame_rect(0);
+	m_half_size= c_Vec2(animation.get_size().x / 2, animation.get_size().y / 2);
+}
+
+// fires one volley, direction is 1 facing right and -1 facing left
+void Projectile_System::fire(e_Weapon weapon, const c_Vec2 &position, float direction, size_t now)
+{
+	const weapon_config &config= WEAPONS[(size_t)weapon];
+
+	for (int shot= 0; shot < config.shots; shot++)
+	{
+		if (m_count == m_capacity)
+		{
+			m_dropped++;
+			continue;
+		}
+
+		float radians= (shot - (config.shots - 1) / 2.0f) * config.spread * 3.14159265f / 180.0f;
+
+		size_t i= m_count++;
+		m_x[i]=			 position.x;
+		m_y[i]=			 position.y;
+		m_velocity_x[i]= config.speed * std::cos(radians) * direction;
+		m_velocity_y[i]= config.speed * std::sin(radians);
+		m_end[i]=		 (uint32_t)(now + config.lifespan);
+		m_hits[i]=		 config.pierce;
+	}
+}
+
+// moves every shot then packs the ones still live to the front, the movement loop
+// touches only float arrays so the compiler can vectorize it
+void Projectile_System::update(size_t now)
+{
+	size_t count= m_count;
+	float *x= m_x.data();
+	float *y= m_y.data();
+	const float *velocity_x= m_velocity_x.data();
+	const float *velocity_y= m_velocity_y.data();
+
+	for (size_t i= 0; i < count; i++)
+	{
+		x[i]+= velocity_x[i];
+		y[i]+= velocity_y[i];
+	}
+
+	size_t live= 0;
+	for (size_t i= 0; i < count; i++)
+	{
+		if (m_end[i] <= now || m_hits[i] == 0) { continue; }
+
+		if (live != i)
+		{
+			m_x[live]=			m_x[i];
+			m_y[live]=			m_y[i];
+			m_velocity_x[live]= m_velocity_x[i];
+			m_velocity_y[live]= m_velocity_y[i];
+			m_end[live]=		m_end[i];
+			m_hits[live]=		m_hits[i];
+		}
+		live++;
+	}
+	m_count= live;
+}
+
+// a shot that stops is spent at once, otherwise it uses up one of its hits. False when the
+// shot was already spent by an earlier hit this frame, which then must not happen
+bool Projectile_System::hit(uint32_t index, bool stop)
+{
+	if (m_hits[index] == 0) { return false; }
+
+	if (stop || m_hits[index] <= 1)
+	{
+		m_hits[index]= 0;
+	}
+	else
+	{
+		m_hits[index]--;
+	}
+	return true;
+}
+
+void Projectile_System::clear()
+{
+	m_count= 0;
+}
+
+// adds a sprite per visible shot, they all share one texture so they draw in one call
+void Projectile_System::draw(Render_List &list, float view_left, float view_right) const
+{
+	for (size_t i= 0; i < m_count; i++)
+	{
+		if (m_hits[i] == 0) { continue; }
+		if (m_x[i] + m_half_size.x < view_left || m_x[i] - m_half_size.x > view_right) { continue; }
+
+		list.sprite(e_Layer::World, m_texture, m_rect, sf::Vector2f(m_half_size.x, m_half_size.y), sf::Vector2f(m_x[i], m_y[i]));
+	}
+}
+
+void Projectile_System::clear_targets()
+{
+	m_targets.clear();
+}
+
+void Projectile_System::add_target(Entity &entity, const c_Vec2 &position, const c_Vec2 &half_size, bool stops)
+{
+	target &t= m_targets.emplace_back();
+	t.entity= &entity;
+	t.stops=  stops;
+	t.left=	  position.x - half_size.x;
+	t.right=  position.x + half_size.x;
+	t.top=	  position.y - half_size.y;
+	t.bottom= position.y + half_size.y;
+}
+
+// a counting sort of the targets into the grid's columns. Anything left or right of the
+// level is filed under its first or last column
+void Projectile_System::build_buckets(const Tile_Colliders &tiles)
+{
+	int columns= tiles.columns();
+	m_column_start.assign(columns + 1, 0);
+	m_buckets.clear();
+	if (columns == 0) { return; }
+
+	auto span= [&](target &t, int &first, int &last)
+	{
+		first= std::clamp(tiles.first_column(t.left), 0, columns - 1);
+		last=  std::clamp(tiles.last_column(t.right), 0, columns - 1);
+		t.first_column= first;
+	};
+
+	int first, last;
+	for (target &t : m_targets)
+	{
+		span(t, first, last);
+		for (int c= first; c <= last; c++)
+		{
+			m_column_start[c + 1]++;
+		}
+	}
+	for (int c= 0; c < columns; c++)
+	{
+		m_column_start[c + 1]+= m_column_start[c];
+	}
+	m_buckets.resize(m_column_start[columns]);
+
+	// fill using each column's start as its cursor, which leaves it at the next column's
+	// start, then shift the starts back into place
+	for (uint32_t k= 0; k < m_targets.size(); k++)
+	{
+		span(m_targets[k], first, last);
+		for (int c= first; c <= last; c++)
+		{
+			m_buckets[m_column_start[c]++]= k;
+		}
+	}
+	for (int c= columns; c > 0; c--)
+	{
+		m_column_start[c]= m_column_start[c - 1];
+	}
+	m_column_start[0]= 0;
+}
+
+// only shots that can still hit anything are kept
+void Projectile_System::save(Snapshot::Writer &writer) const
+{
+	uint32_t live= 0;
+	for (size_t i= 0; i < m_count; i++)
+	{
+		live+= m_hits[i] > 0;
+	}
+
+	writer.write<uint32_t>(live);
+	for (size_t i= 0; i < m_count; i++)
+	{
+		if (m_hits[i] == 0) { continue; }
+
+		writer.write(m_x[i]);
+		writer.write(m_y[i]);
+		writer.write(m_velocity_x[i]);
+		writer.write(m_velocity_y[i]);
+		writer.write(m_end[i]);
+		writer.write(m_hits[i]);
+	}
+}
+
+void Projectile_System::load(Snapshot::Reader &reader)
+{
+	m_count= reader.read<uint32_t>();
+	for (size_t i= 0; i < m_count; i++)
+	{
+		m_x[i]=			 reader.read<float>();
+		m_y[i]=			 reader.read<float>();
+		m_velocity_x[i]= reader.read<float>();
+		m_velocity_y[i]= reader.read<float>();
+		m_end[i]=		 reader.read<uint32_t>();
+		m_hits[i]=		 reader.read<uint8_t>();
+	}
+}
+
+size_t Projectile_System::size() const
+{
+	return m_count;
+}
+
+size_t Projectile_System::capacity() const
+{
+	return m_capacity;
+}
+
+size_t Projectile_System::dropped() const
+{
+	return m_dropped;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Common.h"
+#include "Tile_Colliders.h"
+
+#include <algorithm>
+#include <cstdint>
+
+class Animation;
+class Entity;
+class Render_List;
+namespace Snapshot { class Writer; class Reader; }
+
+enum class e_Weapon : uint8_t { Buster, Rapid, Spread, Pierce, Count };
+
+inline constexpr const char *WEAPON_NAMES[(size_t)e_Weapon::Count + 1]= { "Buster", "Rapid", "Spread", "Pierce", nullptr };
+
+struct weapon_config
+{
+	int		cooldown= 0;		// frames between shots while the button is held, 0 fires once per press
+	int		shots=	  1;		// fired at once, fanned out around the facing direction
+	float	spread=	  0;		// degrees between neighbouring shots
+	float	speed=	  10;
+	uint8_t pierce=	  1;		// enemies a shot can hit before it is spent
+	int		lifespan= 180;		// frames
+};
+
+// The player's shots, kept out of the entity manager in a fixed capacity structure of
+// arrays like the particles. Movement is a plain loop over float arrays. Hits are found
+// in bulk: solid tiles by looking up the grid cells a shot covers, everything else that
+// can be hit by checking only the boxes filed under the grid columns the shot is in.
+// A shot is referred to by its index, which stays valid until the next update
+class Projectile_System
+{
+	// a box a shot can hit that is not a merged tile, filed under every column it covers
+	struct target
+	{
+		Entity *entity=		  nullptr;
+		float	left= 0, right= 0, top= 0, bottom= 0;
+		int		first_column= 0;	// the first bucket it is in
+		bool	stops= false;		// a tile with a box of its own, which a shot cannot pierce
+	};
+
+	const sf::Texture				   *m_texture= nullptr;
+	sf::IntRect							m_rect;
+	c_Vec2								m_half_size;
+
+	size_t								m_capacity= 0;
+	size_t								m_count= 0;
+	size_t								m_dropped= 0;
+	std::vector<float>					m_x;
+	std::vector<float>					m_y;
+	std::vector<float>					m_velocity_x;
+	std::vector<float>					m_velocity_y;
+	std::vector<uint32_t>				m_end;				// first frame it is gone on
+	std::vector<uint8_t>				m_hits;				// hits left, 0 once it is spent
+
+	std::vector<target>					m_targets;
+	std::vector<uint32_t>				m_column_start;		// first bucket entry of each column, plus one past the end
+	std::vector<uint32_t>				m_buckets;			// target indices grouped by column
+
+	void build_buckets(const Tile_Colliders &tiles);
+
+public:
+
+	static const size_t RECORD_SIZE= 4 * sizeof(float) + sizeof(uint32_t) + 1;
+
+	Projectile_System(size_t capacity= 4096);
+
+	static const weapon_config &weapon(e_Weapon weapon);
+	static e_Weapon				weapon_id(const std::string &name);
+	static uint8_t				max_pierce();
+
+	void set_sprite(const Animation &animation);
+	void fire(e_Weapon weapon, const c_Vec2 &position, float direction, size_t now);
+	void update(size_t now);
+	bool hit(uint32_t index, bool stop);
+	void clear();
+	void draw(Render_List &list, float view_left, float view_right) const;
+
+	void clear_targets();
+	void add_target(Entity &entity, const c_Vec2 &position, const c_Vec2 &half_size, bool stops);
+
+	// calls on_tile(index, tile) at most once per live shot, for a merged tile or a target
+	// that stops it, and on_target(index, entity) for at most as many other targets as the
+	// shot has hits left. A frame's hits are then bounded by capacity() tiles and
+	// capacity() * max_pierce() targets
+	template <typename T, typename U>
+	void collide(const Tile_Colliders &tiles, T on_tile, U on_target);
+
+	void save(Snapshot::Writer &writer) const;
+	void load(Snapshot::Reader &reader);
+
+	size_t size() const;
+	size_t capacity() const;
+	size_t dropped() const;
+};
+
+template <typename T, typename U>
+void Projectile_System::collide(const Tile_Colliders &tiles, T on_tile, U on_target)
+{
+	build_buckets(tiles);
+	int last_bucket= tiles.columns() - 1;
+
+	for (uint32_t i= 0; i < m_count; i++)
+	{
+		if (m_hits[i] == 0) { continue; }
+
+		float left=	  m_x[i] - m_half_size.x;
+		float right=  m_x[i] + m_half_size.x;
+		float top=	  m_y[i] - m_half_size.y;
+		float bottom= m_y[i] + m_half_size.y;
+
+		int c0= tiles.first_column(left);
+		int c1= tiles.last_column(right);
+
+		// a target covering several columns is filed under each of them, it is only
+		// considered from the first column it shares with the shot. A tile always stops
+		// a shot, so the first one found is the only one reported, tiles with boxes of
+		// their own before merged ones as they are the ones a hit can change. A level with
+		// no columns has no buckets to scan
+		Entity *tile= nullptr;
+		uint8_t hits= m_hits[i];
+		int first= 0;
+		int last=  -1;
+		if (last_bucket >= 0)
+		{
+			first= std::clamp(c0, 0, last_bucket);
+			last=  std::clamp(c1, 0, last_bucket);
+		}
+		for (int c= first; c <= last && !tile; c++)
+		{
+			for (uint32_t k= m_column_start[c]; k < m_column_start[c + 1] && !tile; k++)
+			{
+				const target &t= m_targets[m_buckets[k]];
+				if (t.left >= right || t.right <= left || t.top >= bottom || t.bottom <= top) { continue; }
+				if (c != std::max(first, t.first_column)) { continue; }
+
+				if (t.stops)
+				{
+					tile= t.entity;
+				}
+				else if (hits > 0)
+				{
+					on_target(i, *t.entity);
+					hits--;
+				}
+			}
+		}
+
+		for (int r= tiles.first_row(bottom); r <= tiles.last_row(top) && !tile; r++)
+		{
+			for (int c= c0; c <= c1 && !tile; c++)
+			{
+				tile= tiles.get_tile(c, r);
+			}
+		}
+
+		if (tile) { on_tile(i, *tile); }
+	}
+}
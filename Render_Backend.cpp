@@ -0,0 +1,345 @@
+#include "Render_Backend.h"
+#include "Assets.h"
+
+#include <cmath>
+#include <cstdio>
+
+render_stats &render_stats::operator+=(const render_stats &other)
+{
+	commands+=	other.commands;
+	sprites+=	other.sprites;
+	lines+=		other.lines;
+	rects+=		other.rects;
+	texts+=		other.texts;
+	grids+=		other.grids;
+	batches+=	other.batches;
+	return *this;
+}
+
+// sprites and rects both become quads, the rects untextured, so a run of either with
+// one texture is one draw call, as is any run of lines. Every text is a call of its
+// own and every grid two, its lines and its labels
+bool Render_Backend::same_batch(const render_command &a, const render_command &b)
+{
+	if (a.type == e_Draw::Text || b.type == e_Draw::Text) { return false; }
+	if (a.type == e_Draw::Grid || b.type == e_Draw::Grid) { return false; }
+	if ((a.type == e_Draw::Line) != (b.type == e_Draw::Line)) { return false; }
+	return a.texture == b.texture;
+}
+
+void Render_Backend::submit(const Render_List &list)
+{
+	const std::vector<render_command> &commands= list.commands();
+
+	// scenes mostly add commands in key order already, which the sort handles quickly
+	m_order.resize(commands.size());
+	for (uint32_t i= 0; i < m_order.size(); i++)
+	{
+		m_order[i]= i;
+	}
+	std::sort(m_order.begin(), m_order.end(), [&](uint32_t a, uint32_t b) { return commands[a].key < commands[b].key; });
+
+	m_stats= render_stats();
+	m_stats.commands= commands.size();
+	m_batches.clear();
+
+	for (uint32_t i= 0; i < m_order.size(); i++)
+	{
+		const render_command &command= commands[m_order[i]];
+		switch (command.type)
+		{
+			case e_Draw::Sprite:	m_stats.sprites++;	break;
+			case e_Draw::Line:		m_stats.lines++;	break;
+			case e_Draw::Rect:		m_stats.rects++;	break;
+			case e_Draw::Text:		m_stats.texts++;	break;
+			case e_Draw::Grid:		m_stats.grids++;	break;
+		}
+
+		if (i == 0 || !same_batch(commands[m_order[i - 1]], command))
+		{
+			m_batches.push_back(i);
+		}
+	}
+	m_stats.batches= m_batches.size() + m_stats.grids;
+	m_batches.push_back((uint32_t)m_order.size());
+
+	draw(list, m_order, m_batches);
+
+	m_total+= m_stats;
+	m_frames++;
+}
+
+const render_stats &Render_Backend::stats() const
+{
+	return m_stats;
+}
+
+const render_stats &Render_Backend::total() const
+{
+	return m_total;
+}
+
+size_t Render_Backend::frames() const
+{
+	return m_frames;
+}
+
+SFML_Render_Backend::SFML_Render_Backend(sf::RenderTarget &target, const Assets &assets)
+	: m_target(target)
+	, m_assets(assets)
+{
+	m_vertices.reserve(4 * 4096);
+	m_grid_lines.reserve(256);
+	m_grid_labels.reserve(4 * 4096);
+}
+
+// the same transform sf::Sprite applies: origin, scale, rotation, then position
+void SFML_Render_Backend::add_sprite(const render_command &command)
+{
+	float width= (float)command.rect.width;
+	float height= (float)command.rect.height;
+	float radians= command.angle * 3.14159265f / 180.0f;
+	float cosine= std::cos(radians);
+	float sine= std::sin(radians);
+
+	auto corner= [&](float x, float y, float u, float v)
+	{
+		float local_x= (x - command.origin.x) * command.scale.x;
+		float local_y= (y - command.origin.y) * command.scale.y;
+		sf::Vector2f position(command.position.x + local_x * cosine - local_y * sine, command.position.y + local_x * sine + local_y * cosine);
+		m_vertices.push_back(sf::Vertex(position, sf::Vector2f(u, v)));
+	};
+
+	float u0= (float)command.rect.left;
+	float v0= (float)command.rect.top;
+	corner(0, 0, u0, v0);
+	corner(width, 0, u0 + width, v0);
+	corner(width, height, u0 + width, v0 + height);
+	corner(0, height, u0, v0 + height);
+}
+
+// a one pixel outline around the box, where an sf::RectangleShape of size - 1 with an
+// outline thickness of 1 would put it
+void SFML_Render_Backend::add_rect(const render_command &command)
+{
+	float left= command.position.x - command.size.x / 2 - 1;
+	float top= command.position.y - command.size.y / 2 - 1;
+	float right= command.position.x + command.size.x / 2;
+	float bottom= command.position.y + command.size.y / 2;
+
+	auto quad= [&](float x0, float y0, float x1, float y1)
+	{
+		m_vertices.push_back(sf::Vertex(sf::Vector2f(x0, y0), command.color));
+		m_vertices.push_back(sf::Vertex(sf::Vector2f(x1, y0), command.color));
+		m_vertices.push_back(sf::Vertex(sf::Vector2f(x1, y1), command.color));
+		m_vertices.push_back(sf::Vertex(sf::Vector2f(x0, y1), command.color));
+	};
+
+	quad(left, top, right, top + 1);
+	quad(left, bottom - 1, right, bottom);
+	quad(left, top + 1, left + 1, bottom - 1);
+	quad(right - 1, top + 1, right, bottom - 1);
+}
+
+void SFML_Render_Backend::draw_text(const Render_List &list, const render_command &command, size_t slot)
+{
+	if (slot == m_texts.size())
+	{
+		m_texts.emplace_back();
+		m_strings.emplace_back();
+	}
+
+	sf::Text &text= m_texts[slot];
+	std::string_view string= list.text(command);
+
+	text.setFont(m_assets.get_font(command.font));
+	text.setCharacterSize(command.character_size);
+	text.setFillColor(command.color);
+	text.setPosition(command.position);
+	if (m_strings[slot] != string)
+	{
+		m_strings[slot].assign(string);
+		text.setString(m_strings[slot]);
+	}
+
+	m_target.draw(text);
+}
+
+// the lines and labels of every cell the command covers. Labels are glyph quads from
+// the font texture so they are one draw call, their glyphs are loaded here on the
+// render thread, the same thread that draws every sf::Text from these fonts
+void SFML_Render_Backend::build_grid(const render_command &command)
+{
+	m_grid= command;
+	m_grid_lines.clear();
+	m_grid_labels.clear();
+
+	const sf::Font &font= m_assets.get_font(command.font);
+	int first_column= command.rect.left;
+	int last_column= command.rect.left + command.rect.width - 1;
+	float bottom= command.position.y;
+	float top= bottom - command.rect.height * command.size.y;
+	float left_x= first_column * command.size.x;
+	float right_x= (last_column + 1) * command.size.x;
+
+	for (int column= first_column; column <= last_column + 1; column++)
+	{
+		m_grid_lines.push_back(sf::Vertex(sf::Vector2f(column * command.size.x, top), command.color));
+		m_grid_lines.push_back(sf::Vertex(sf::Vector2f(column * command.size.x, bottom), command.color));
+	}
+
+	for (int row= 0; row < command.rect.height; row++)
+	{
+		m_grid_lines.push_back(sf::Vertex(sf::Vector2f(left_x, bottom - row * command.size.y), command.color));
+		m_grid_lines.push_back(sf::Vertex(sf::Vector2f(right_x, bottom - row * command.size.y), command.color));
+	}
+
+	for (int row= 0; row < command.rect.height; row++)
+	{
+		for (int column= first_column; column <= last_column; column++)
+		{
+			char label[32];
+			std::snprintf(label, sizeof(label), "( %d , %d )", column, row);
+
+			// sf::Text puts the baseline one character size below its position
+			float pen_x= column * command.size.x + 3;
+			float baseline= bottom - row * command.size.y - command.size.y + 2 + command.character_size;
+
+			for (const char *c= label; *c; c++)
+			{
+				const sf::Glyph &glyph= font.getGlyph(*c, command.character_size, false);
+
+				// glyph bounds and texture rects are the same size, so a glyph is an unscaled quad
+				float x= pen_x + glyph.bounds.left;
+				float y= baseline + glyph.bounds.top;
+				float width= (float)glyph.textureRect.width;
+				float height= (float)glyph.textureRect.height;
+				float u= (float)glyph.textureRect.left;
+				float v= (float)glyph.textureRect.top;
+
+				m_grid_labels.push_back(sf::Vertex(sf::Vector2f(x, y), command.color, sf::Vector2f(u, v)));
+				m_grid_labels.push_back(sf::Vertex(sf::Vector2f(x + width, y), command.color, sf::Vector2f(u + width, v)));
+				m_grid_labels.push_back(sf::Vertex(sf::Vector2f(x + width, y + height), command.color, sf::Vector2f(u + width, v + height)));
+				m_grid_labels.push_back(sf::Vertex(sf::Vector2f(x, y + height), command.color, sf::Vector2f(u, v + height)));
+
+				pen_x+= glyph.advance;
+			}
+		}
+	}
+
+	m_grid_texture= &font.getTexture(command.character_size);
+}
+
+// most frames ask for the same grid as the last, which draws straight from the cache
+void SFML_Render_Backend::draw_grid(const render_command &command)
+{
+	if (m_grid.type != e_Draw::Grid || m_grid.font != command.font || m_grid.character_size != command.character_size
+		|| m_grid.color != command.color || m_grid.size != command.size || m_grid.position != command.position || m_grid.rect != command.rect)
+	{
+		build_grid(command);
+	}
+
+	m_target.draw(m_grid_lines.data(), m_grid_lines.size(), sf::Lines);
+	m_target.draw(m_grid_labels.data(), m_grid_labels.size(), sf::Quads, sf::RenderStates(m_grid_texture));
+}
+
+void SFML_Render_Backend::draw(const Render_List &list, const std::vector<uint32_t> &order, const std::vector<uint32_t> &batches)
+{
+	const std::vector<render_command> &commands= list.commands();
+
+	m_target.clear(list.clear_color);
+	m_target.setView(sf::View(list.view_center, list.view_size));
+
+	size_t text_slot= 0;
+	for (size_t b= 0; b + 1 < batches.size(); b++)
+	{
+		const render_command &first= commands[order[batches[b]]];
+
+		if (first.type == e_Draw::Text)
+		{
+			draw_text(list, first, text_slot++);
+			continue;
+		}
+		if (first.type == e_Draw::Grid)
+		{
+			draw_grid(first);
+			continue;
+		}
+
+		m_vertices.clear();
+		for (uint32_t i= batches[b]; i < batches[b + 1]; i++)
+		{
+			const render_command &command= commands[order[i]];
+			switch (command.type)
+			{
+				case e_Draw::Sprite:	add_sprite(command); break;
+				case e_Draw::Rect:		add_rect(command); break;
+				case e_Draw::Line:
+					m_vertices.push_back(sf::Vertex(command.position, command.color));
+					m_vertices.push_back(sf::Vertex(command.end, command.color));
+					break;
+				case e_Draw::Text:
+				case e_Draw::Grid:		break;
+			}
+		}
+
+		sf::PrimitiveType primitive= first.type == e_Draw::Line ? sf::Lines : sf::Quads;
+		m_target.draw(m_vertices.data(), m_vertices.size(), primitive, sf::RenderStates(first.texture));
+	}
+}
+
+void Recording_Render_Backend::draw(const Render_List &list, const std::vector<uint32_t> &order, const std::vector<uint32_t> &)
+{
+	m_commands.clear();
+	m_text.clear();
+
+	for (uint32_t index : order)
+	{
+		const render_command &original= list.commands()[index];
+		render_command &command= m_commands.emplace_back(original);
+		if (command.type == e_Draw::Text)
+		{
+			command.text_offset= (uint32_t)m_text.size();
+			m_text+= list.text(original);
+		}
+	}
+}
+
+const std::vector<render_command> &Recording_Render_Backend::commands() const
+{
+	return m_commands;
+}
+
+// one line per command in draw order, texture pointers left out so runs can be diffed
+void Recording_Render_Backend::write(std::ostream &out) const
+{
+	static const char *LAYERS[]= { "world", "effects", "debug", "overlay" };
+
+	for (const render_command &command : m_commands)
+	{
+		out << LAYERS[command.key >> 32] << ' ';
+		switch (command.type)
+		{
+			case e_Draw::Sprite:
+				out << "sprite " << command.rect.left << ',' << command.rect.top << ' ' << command.rect.width << 'x' << command.rect.height
+					<< " at " << command.position.x << ',' << command.position.y << " scale " << command.scale.x << ',' << command.scale.y
+					<< " angle " << command.angle;
+				break;
+			case e_Draw::Line:
+				out << "line " << command.position.x << ',' << command.position.y << " to " << command.end.x << ',' << command.end.y;
+				break;
+			case e_Draw::Rect:
+				out << "rect " << command.size.x << 'x' << command.size.y << " at " << command.position.x << ',' << command.position.y;
+				break;
+			case e_Draw::Text:
+				out << "text \"" << std::string_view(m_text.data() + command.text_offset, command.text_length) << "\" size " << command.character_size
+					<< " at " << command.position.x << ',' << command.position.y;
+				break;
+			case e_Draw::Grid:
+				out << "grid " << command.rect.width << 'x' << command.rect.height << " cells of " << command.size.x << 'x' << command.size.y
+					<< " from column " << command.rect.left << " up from " << command.position.y;
+				break;
+		}
+		out << '\n';
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Common.h"
+#include "Render_List.h"
+
+#include <string>
+#include <vector>
+
+class Assets;
+
+// the draw work of one frame, a batch is one draw call
+struct render_stats
+{
+	size_t commands= 0;
+	size_t sprites=	 0;
+	size_t lines=	 0;
+	size_t rects=	 0;
+	size_t texts=	 0;
+	size_t grids=	 0;
+	size_t batches=	 0;
+
+	render_stats &operator+=(const render_stats &other);
+};
+
+// Consumes render lists. submit() sorts the commands by key and splits them into
+// batches, runs of commands one draw call can cover, then hands both to draw().
+// Sorting and batching are the same for every backend, so the counts a null backend
+// reports headless are the draw calls the SFML backend makes in the game
+class Render_Backend
+{
+	std::vector<uint32_t>	m_order;			// command indices in key order
+	std::vector<uint32_t>	m_batches;			// where each batch starts in m_order, plus the end
+	render_stats			m_stats;
+	render_stats			m_total;
+	size_t					m_frames= 0;
+
+protected:
+
+	virtual void draw(const Render_List &list, const std::vector<uint32_t> &order, const std::vector<uint32_t> &batches)= 0;
+
+public:
+
+	virtual ~Render_Backend()= default;
+
+	void submit(const Render_List &list);
+
+	static bool same_batch(const render_command &a, const render_command &b);
+
+	const render_stats &stats() const;			// of the last frame
+	const render_stats &total() const;
+	size_t				frames() const;
+};
+
+// Draws to an SFML render target. Sprites and rect outlines become quads and lines
+// become line vertices, one vertex array per batch; texts are drawn one by one from
+// a pool of sf::Text that only relays out when its string or style changes. The debug
+// grid is built here as two vertex arrays that are kept and drawn as they are until a
+// different grid is asked for, fonts are only ever touched on this thread
+class SFML_Render_Backend : public Render_Backend
+{
+	sf::RenderTarget		   &m_target;
+	const Assets			   &m_assets;
+	std::vector<sf::Vertex>		m_vertices;
+	std::vector<sf::Text>		m_texts;
+	std::vector<std::string>	m_strings;		// what each pooled text was last set to
+	render_command				m_grid;			// the grid the cached vertices were built for
+	std::vector<sf::Vertex>		m_grid_lines;
+	std::vector<sf::Vertex>		m_grid_labels;
+	const sf::Texture		   *m_grid_texture= nullptr;
+
+	void add_sprite(const render_command &command);
+	void add_rect(const render_command &command);
+	void draw_text(const Render_List &list, const render_command &command, size_t slot);
+	void build_grid(const render_command &command);
+	void draw_grid(const render_command &command);
+
+protected:
+
+	void draw(const Render_List &list, const std::vector<uint32_t> &order, const std::vector<uint32_t> &batches) override;
+
+public:
+
+	SFML_Render_Backend(sf::RenderTarget &target, const Assets &assets);
+};
+
+// Draws nothing, for benchmarking the render preparation and counting its draw work headless
+class Null_Render_Backend : public Render_Backend
+{
+protected:
+
+	void draw(const Render_List &, const std::vector<uint32_t> &, const std::vector<uint32_t> &) override {}
+};
+
+// Keeps the last frame's commands in draw order and can print them, so a frame's
+// render output can be compared against a known good one
+class Recording_Render_Backend : public Render_Backend
+{
+	std::vector<render_command> m_commands;
+	std::string					m_text;
+
+protected:
+
+	void draw(const Render_List &list, const std::vector<uint32_t> &order, const std::vector<uint32_t> &batches) override;
+
+public:
+
+	const std::vector<render_command> &commands() const;
+	void write(std::ostream &out) const;
+};
@@ -0,0 +1,90 @@
+#include "Render_List.h"
+
+void Render_List::reserve(size_t commands, size_t characters)
+{
+	m_commands.reserve(commands);
+	m_text.reserve(characters);
+}
+
+void Render_List::clear()
+{
+	m_commands.clear();
+	m_text.clear();
+	m_sequence= 0;
+}
+
+render_command &Render_List::add(e_Layer layer, e_Draw type)
+{
+	render_command &command= m_commands.emplace_back();
+	command.key= ((uint64_t)layer << 32) | m_sequence++;
+	command.type= type;
+	return command;
+}
+
+void Render_List::sprite(e_Layer layer, const sf::Texture *texture, const sf::IntRect &rect, const sf::Vector2f &origin,
+						 const sf::Vector2f &position, const sf::Vector2f &scale, float angle)
+{
+	render_command &command= add(layer, e_Draw::Sprite);
+	command.texture=	texture;
+	command.rect=		rect;
+	command.origin=		origin;
+	command.position=	position;
+	command.scale=		scale;
+	command.angle=		angle;
+}
+
+void Render_List::line(e_Layer layer, const sf::Vector2f &start, const sf::Vector2f &end, const sf::Color &color)
+{
+	render_command &command= add(layer, e_Draw::Line);
+	command.position=	start;
+	command.end=		end;
+	command.color=		color;
+}
+
+void Render_List::rect(e_Layer layer, const sf::Vector2f &center, const sf::Vector2f &size, const sf::Color &color)
+{
+	render_command &command= add(layer, e_Draw::Rect);
+	command.position=	center;
+	command.size=		size;
+	command.color=		color;
+}
+
+void Render_List::text(e_Layer layer, e_Font font, unsigned character_size, const sf::Color &color, const sf::Vector2f &position, std::string_view string)
+{
+	render_command &command= add(layer, e_Draw::Text);
+	command.font=			font;
+	command.character_size= (uint16_t)character_size;
+	command.color=			color;
+	command.position=		position;
+	command.text_offset=	(uint32_t)m_text.size();
+	command.text_length=	(uint32_t)string.size();
+	m_text.insert(m_text.end(), string.begin(), string.end());
+}
+
+// one command however many cells are in view, the backend builds the lines and labels
+// itself and keeps them until a different grid is asked for
+void Render_List::grid(e_Layer layer, e_Font font, unsigned character_size, const sf::Vector2f &cell_size, float bottom, int first_column, int columns, int rows)
+{
+	render_command &command= add(layer, e_Draw::Grid);
+	command.font=			font;
+	command.character_size= (uint16_t)character_size;
+	command.color=			sf::Color::White;
+	command.size=			cell_size;
+	command.position=		sf::Vector2f(0, bottom);
+	command.rect=			sf::IntRect(first_column, 0, columns, rows);
+}
+
+const std::vector<render_command> &Render_List::commands() const
+{
+	return m_commands;
+}
+
+std::string_view Render_List::text(const render_command &command) const
+{
+	return std::string_view(m_text.data() + command.text_offset, command.text_length);
+}
+
+size_t Render_List::size() const
+{
+	return m_commands.size();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Common.h"
+#include "Asset_IDs.h"
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+enum class e_Draw : uint8_t { Sprite, Line, Rect, Text, Grid };
+
+// layers draw in this order, within a layer commands draw in the order they were added
+enum class e_Layer : uint8_t { World, Effects, Debug, Overlay };
+
+// One thing to draw, plain values only so a list can be copied, compared and
+// replayed anywhere. Which fields mean what depends on the type:
+//   Sprite: texture, rect, origin, position, scale, angle
+//   Line:	 position to end, color
+//   Rect:	 outline of size centered on position, color
+//   Text:	 font, character_size, color, position, text_offset/text_length into the list's text
+//   Grid:	 cells of size counted up from a bottom edge at position.y, columns rect.left on for
+//			 rect.width columns and rect.height rows, each labelled in font, character_size, color
+struct render_command
+{
+	uint64_t			key= 0;				// layer in the high bits, submission order in the low ones
+	e_Draw				type= e_Draw::Sprite;
+	e_Font				font= e_Font::Count;
+	uint16_t			character_size= 0;
+	sf::Color			color;
+	const sf::Texture  *texture= nullptr;
+	sf::IntRect			rect;
+	sf::Vector2f		position;
+	sf::Vector2f		origin;
+	sf::Vector2f		scale;
+	sf::Vector2f		end;
+	sf::Vector2f		size;
+	float				angle= 0;
+	uint32_t			text_offset= 0;
+	uint32_t			text_length= 0;
+};
+
+static_assert(std::is_trivially_copyable_v<render_command>, "render commands are copied as plain bytes");
+
+// What a scene wants drawn this frame, in no particular order. Scenes fill it, a
+// Render_Backend sorts it by key, batches it and draws it. Clearing keeps the capacity,
+// so once a list has seen a busy frame filling it never allocates
+class Render_List
+{
+	std::vector<render_command> m_commands;
+	std::vector<char>			m_text;				// the characters of every text command
+	uint32_t					m_sequence= 0;
+
+	render_command &add(e_Layer layer, e_Draw type);
+
+public:
+
+	sf::Color			clear_color;
+	sf::Vector2f		view_center;
+	sf::Vector2f		view_size;
+
+	void reserve(size_t commands, size_t characters);
+	void clear();
+
+	void sprite(e_Layer layer, const sf::Texture *texture, const sf::IntRect &rect, const sf::Vector2f &origin,
+				const sf::Vector2f &position, const sf::Vector2f &scale= { 1, 1 }, float angle= 0);
+	void line(e_Layer layer, const sf::Vector2f &start, const sf::Vector2f &end, const sf::Color &color= sf::Color::White);
+	void rect(e_Layer layer, const sf::Vector2f &center, const sf::Vector2f &size, const sf::Color &color= sf::Color::White);
+	void text(e_Layer layer, e_Font font, unsigned character_size, const sf::Color &color, const sf::Vector2f &position, std::string_view string);
+	void grid(e_Layer layer, e_Font font, unsigned character_size, const sf::Vector2f &cell_size, float bottom, int first_column, int columns, int rows);
+
+	const std::vector<render_command> &commands() const;
+	std::string_view text(const render_command &command) const;
+	size_t size() const;
+};
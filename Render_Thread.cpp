@@ -0,0 +1,115 @@
+#include "Render_Thread.h"
+#include "Trace.h"
+
+Render_Thread::Render_Thread()
+{
+	// sized for the busiest frames of the shipped levels
+	for (auto &frame : m_frames)
+	{
+		frame.list.reserve(8192, 1024);
+		frame.inputs.reserve(256);		// room for the inputs of a few frames that were never drawn
+	}
+}
+
+Render_Thread::~Render_Thread()
+{
+	stop();
+}
+
+// the window's GL context moves to the render thread, the window itself stays with
+// the main thread, which still has to poll its events
+void Render_Thread::start(sf::RenderWindow &window, Render_Backend &backend)
+{
+	if (m_running) { return; }
+
+	m_window= &window;
+	m_backend= &backend;
+	m_window->setActive(false);
+
+	m_running= true;
+	m_thread= std::thread(&Render_Thread::render, this);
+}
+
+void Render_Thread::stop()
+{
+	if (!m_running) { return; }
+
+	m_running= false;
+	m_ready.fetch_or(NEW_FRAME);
+	m_ready.notify_one();
+	m_thread.join();
+
+	m_window->setActive(true);
+}
+
+Render_Frame &Render_Thread::back_frame()
+{
+	return m_frames[m_back];
+}
+
+// hands the back frame over and takes the oldest frame nobody is using as the next back frame
+void Render_Thread::publish()
+{
+	uint32_t previous= m_ready.exchange(m_back | NEW_FRAME, std::memory_order_acq_rel);
+	m_ready.notify_one();
+	m_back= previous & INDEX_MASK;
+	m_frames[m_back].list.clear();
+
+	// a frame still flagged new was never drawn, its inputs stay and go out with the next
+	// frame so they are measured when that one reaches the screen instead of being dropped
+	if (!(previous & NEW_FRAME))
+	{
+		m_frames[m_back].inputs.clear();
+	}
+	m_published++;
+}
+
+void Render_Thread::render()
+{
+	Trace::name_thread("render");
+	m_window->setActive(true);
+
+	while (true)
+	{
+		uint32_t ready= m_ready.load(std::memory_order_acquire);
+		if (!(ready & NEW_FRAME))
+		{
+			m_ready.wait(ready, std::memory_order_acquire);
+			continue;
+		}
+		if (!m_running) { break; }
+
+		m_front= m_ready.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+		const Render_Frame &frame= m_frames[m_front];
+
+		{
+			TRACE_SCOPE("render_frame");
+			m_backend->submit(frame.list);
+			m_window->display();
+		}
+
+		auto present= Input_Clock::now();
+		for (auto &time : frame.inputs)
+		{
+			m_input_to_present.record(present - time);
+		}
+		m_drawn++;
+	}
+
+	m_window->setActive(false);
+}
+
+size_t Render_Thread::published() const
+{
+	return m_published;
+}
+
+size_t Render_Thread::drawn() const
+{
+	return m_drawn;
+}
+
+const Latency_Stats &Render_Thread::input_to_present() const
+{
+	return m_input_to_present;
+}
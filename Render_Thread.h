@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Common.h"
+#include "Render_List.h"
+#include "Render_Backend.h"
+#include "Input_Capture.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+// what one tick hands the render thread
+struct Render_Frame
+{
+	Render_List								list;
+	std::vector<Input_Clock::time_point>	inputs;		// capture times of the inputs the tick handled
+};
+
+// Draws frames on its own thread while the simulation runs the next tick. Frames go
+// through three buffers: the simulation fills the back one and publishes it by swapping
+// it with the ready one, the render thread swaps the ready one for its front one when it
+// is newer. Neither side ever waits on the other, a frame the render thread was too slow
+// for is replaced by the next one, so throughput is the slower of the two rather than both
+class Render_Thread
+{
+	static const uint32_t NEW_FRAME=	4;		// set on the ready index until the render thread takes it
+	static const uint32_t INDEX_MASK=	3;
+
+	std::array<Render_Frame, 3> m_frames;
+	uint32_t					m_back= 0;			// only the simulation touches it
+	uint32_t					m_front= 1;			// only the render thread touches it
+	std::atomic<uint32_t>		m_ready{ 2 };
+	std::atomic<bool>			m_running{ false };
+	std::thread					m_thread;
+	sf::RenderWindow		   *m_window= nullptr;
+	Render_Backend			   *m_backend= nullptr;
+
+	size_t						m_published= 0;
+	std::atomic<size_t>			m_drawn{ 0 };
+	Latency_Stats				m_input_to_present;		// only read once the thread has stopped
+
+	void render();
+
+public:
+
+	Render_Thread();
+	~Render_Thread();
+
+	Render_Thread(const Render_Thread &)= delete;
+	Render_Thread &operator=(const Render_Thread &)= delete;
+
+	void start(sf::RenderWindow &window, Render_Backend &backend);
+	void stop();
+
+	Render_Frame &back_frame();
+	void		  publish();
+
+	size_t				 published() const;
+	size_t				 drawn() const;
+	const Latency_Stats &input_to_present() const;
+};
@@ -1,13 +1,33 @@
 #include "Scene.h"
 #include "Game_Engine.h"
+#include "Audio_Mixer.h"
 
 Scene::Scene() 
 {
 	m_current_frame= 0;
 }
 
+// takes the window's size, so only for scenes built on the main thread
 Scene::Scene(Game_Engine *game_engine)
+	: Scene(game_engine, game_engine->window().getSize().x, game_engine->window().getSize().y) {}
+
+// a scene built on a loading thread must not touch the window, its view size is read
+// on the main thread when the load starts and handed in
+Scene::Scene(Game_Engine *game_engine, size_t width, size_t height)
 	: m_game(game_engine)
+	, m_assets(&game_engine->assets())
+	, m_audio(&game_engine->audio())
+	, m_width(width)
+	, m_height(height)
+{
+	m_current_frame= 0;
+}
+
+// a headless scene simulates without a window, its view size is fixed instead
+Scene::Scene(const Assets &assets, size_t width, size_t height)
+	: m_assets(&assets)
+	, m_width(width)
+	, m_height(height)
 {
 	m_current_frame= 0;
 }
@@ -17,6 +37,17 @@ void Scene::set_paused()
 	m_paused= !m_paused;
 }
 
+void Scene::play_sound(e_Sound sound)
+{
+	if (m_audio) { m_audio->play(sound); }
+}
+
+// a headless scene is silent unless it is given a mixer to play into
+void Scene::set_audio(Audio_Mixer *audio)
+{
+	m_audio= audio;
+}
+
 void Scene::simulate(int i)
 {
 	for (int j= 0; j < i; j++)
@@ -25,29 +56,47 @@ void Scene::simulate(int i)
 	}
 }
 
+// calls the handler bound to the action, actions the scene has no handler for are ignored
 void Scene::do_action(const Action &action)
 {
-	s_do_action(action); // ???
+	Action_Handler handler= m_action_handlers[(size_t)action.id()];
+	if (handler)
+	{
+		(this->*handler)(action);
+	}
+}
+
+// the action bound to a key, or e_Action::None for keys the scene does not use
+e_Action Scene::get_action(int input_key) const
+{
+	if (input_key < 0 || input_key >= (int)m_action_map.size()) { return e_Action::None; }
+
+	return m_action_map[input_key];
+}
+
+const Assets &Scene::assets() const
+{
+	return *m_assets;
 }
 
-void Scene::register_action(int input_key, std::string action_name)
+bool Scene::headless() const
 {
-	m_action_map[input_key]= action_name;
+	return m_game == nullptr;
 }
 
-const Action_Map &Scene::get_action_map() const
+bool Scene::has_ended() const
 {
-	return m_action_map;
+	return m_has_ended;
 }
 
 size_t Scene::width() const
 {
-	return m_game->window().getSize().x;
+	return m_width;
 }
 
 size_t Scene::height() const
 {
-	return m_game->window().getSize().y;
+	return m_height;
 }
 
 size_t Scene::current_frame() const
@@ -3,42 +3,94 @@
 #include "Common.h"
 #include "Action.h"
 #include "Entity_Manager.h"
+#include "Asset_IDs.h"
 
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <array>
+#include <functional>
 
 class Game_Engine;
+class Assets;
+class Audio_Mixer;
+class Scene;
+class Render_List;
 
-typedef std::map<int, std::string> Action_Map;
+// keys map straight to action ids and action ids straight to handlers, both flat arrays
+typedef void (Scene::*Action_Handler)(const Action &action);
+typedef std::array<e_Action, sf::Keyboard::KeyCount> Action_Map;
+typedef std::array<Action_Handler, (size_t)e_Action::Count> Action_Handlers;
+
+// builds a scene, possibly on another thread
+typedef std::function<std::shared_ptr<Scene>()> Scene_Builder;
 
 class Scene
 {
 
 protected:
 
-	Game_Engine	   *m_game= nullptr;
-	Entity_Manager	m_entity_manager;
-	Action_Map		m_action_map;
+	Game_Engine	   *m_game= nullptr;		// null for a headless scene, which has no window
+	const Assets   *m_assets= nullptr;
+	Audio_Mixer	   *m_audio= nullptr;		// null when nothing is listening
+
+	// everything that lives as long as the level comes from the arena and goes back to
+	// the heap in one step with it, the arena is declared first so it is destroyed last
+	std::pmr::monotonic_buffer_resource m_arena{ 1 << 20 };
+	std::optional<Entity_Manager> m_entity_manager{ std::in_place, &m_arena };
+	Action_Map		m_action_map= {};
+	Action_Handlers m_action_handlers= {};
 	bool			m_paused= false;
 	bool			m_has_ended= false;
 	size_t			m_current_frame;
+	size_t			m_width= 0;
+	size_t			m_height= 0;
 
 	virtual void on_end()= 0;
 	void set_paused();
+	void play_sound(e_Sound sound);
+
+	// hands everything the level allocated back to the arena in one step. Even an empty
+	// container can own arena memory, a map's head node or a debug iterator proxy, so the
+	// entity manager and the scene's own level memory are all destroyed before the release
+	// and only made again after it
+	template <typename... Ts>
+	void reset_level_memory(std::optional<Ts> &... level_memory)
+	{
+		(level_memory.reset(), ...);
+		m_entity_manager.reset();
+		m_arena.release();
+		m_entity_manager.emplace(&m_arena);
+		(level_memory.emplace(&m_arena), ...);
+	}
+
+	// binds a key to an action and the action to a member function of the derived scene
+	template <typename T>
+	void register_action(int input_key, e_Action action, void (T::*handler)(const Action &))
+	{
+		m_action_map[input_key]= action;
+		m_action_handlers[(size_t)action]= static_cast<Action_Handler>(handler);
+	}
 
 public:
 
 	Scene();
 	Scene(Game_Engine *game_engine);
+	Scene(Game_Engine *game_engine, size_t width, size_t height);
+	Scene(const Assets &assets, size_t width, size_t height);
 
 	virtual void update()= 0;
-	virtual void s_do_action(const Action &action)= 0;
-	virtual void s_render()= 0;
+	virtual void s_render(Render_List &list)= 0;
 
 	void simulate(int i);
 	void do_action(const Action &action);
-	void register_action(int input_key, std::string action_name);
+	void set_audio(Audio_Mixer *audio);
+
+	e_Action get_action(int input_key) const;
 
-	const Action_Map &get_action_map() const;
+	const Assets &assets() const;
+	bool headless() const;
+	bool has_ended() const;
 
 	size_t width() const;
 	size_t height() const;
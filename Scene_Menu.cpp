@@ -5,6 +5,7 @@
 #include "Game_Engine.h"
 #include "Components.h"
 #include "Action.h"
+#include "Render_List.h"
 
 Scene_Menu::Scene_Menu(Game_Engine *game_engine)
 	: Scene(game_engine)
@@ -14,10 +15,10 @@ Scene_Menu::Scene_Menu(Game_Engine *game_engine)
 
 void Scene_Menu::initialize()
 {
-	register_action(sf::Keyboard::W, "UP");
-	register_action(sf::Keyboard::S, "DOWN");
-	register_action(sf::Keyboard::D, "PLAY");
-	register_action(sf::Keyboard::Escape, "QUIT");
+	register_action(sf::Keyboard::W, e_Action::Up, &Scene_Menu::a_up);
+	register_action(sf::Keyboard::S, e_Action::Down, &Scene_Menu::a_down);
+	register_action(sf::Keyboard::D, e_Action::Play, &Scene_Menu::a_play);
+	register_action(sf::Keyboard::Escape, e_Action::Quit, &Scene_Menu::a_quit);
 
 	m_title= "Mega Plumber Man";
 	m_menu_strings.push_back("Level 1");
@@ -27,10 +28,6 @@ void Scene_Menu::initialize()
 	m_level_paths.push_back("level1.txt");
 	m_level_paths.push_back("level2.txt");
 	m_level_paths.push_back("level3.txt");
-
-	m_menu_text.setFont(m_game->assets().get_font("Mario"));
-	m_menu_text.setCharacterSize(60);
-	m_menu_text.setFillColor(sf::Color(0, 0, 0));
 }
 
 void Scene_Menu::on_end()
@@ -41,62 +38,65 @@ void Scene_Menu::on_end()
 void Scene_Menu::update()
 {
 	m_current_frame++;
-	s_render();
-}
 
-void Scene_Menu::s_do_action(const Action &action)
-{
-	if (action.type() == "START")
+	// the highlighted level starts loading straight away, so selecting it swaps in without a wait
+	if (m_preloaded_index != m_menu_index)
 	{
-		if (action.name() == "UP")
-		{
-			if (m_menu_index > 0) { m_menu_index--; }
-			else { m_menu_index= m_menu_strings.size() - 1; }
-		}
-		else if (action.name() == "DOWN")
-		{
-			m_menu_index= (m_menu_index + 1) % m_menu_strings.size();
-		}
-		else if (action.name() == "PLAY")
-		{
-			m_game->change_scene("PLAY", std::make_shared<Scene_Play>(m_game, m_level_paths[m_menu_index]));
-		}
-		else if (action.name() == "QUIT")
-		{
-			on_end();
-		}
+		m_game->preload_scene(m_level_paths[m_menu_index], Scene_Play::builder(m_game, m_level_paths[m_menu_index]));
+		m_preloaded_index= m_menu_index;
 	}
+
+	s_render(m_game->render_list());
+}
+
+// menu actions only happen when the key goes down
+void Scene_Menu::a_up(const Action &action)
+{
+	if (!action.is_start()) { return; }
+
+	if (m_menu_index > 0) { m_menu_index--; }
+	else { m_menu_index= m_menu_strings.size() - 1; }
+}
+
+void Scene_Menu::a_down(const Action &action)
+{
+	if (!action.is_start()) { return; }
+
+	m_menu_index= (m_menu_index + 1) % m_menu_strings.size();
+}
+
+void Scene_Menu::a_play(const Action &action)
+{
+	if (!action.is_start()) { return; }
+
+	m_game->change_scene_async("PLAY", m_level_paths[m_menu_index], Scene_Play::builder(m_game, m_level_paths[m_menu_index]));
+
+	// the preload was used up, load it again when coming back to the menu
+	m_preloaded_index= -1;
+}
+
+void Scene_Menu::a_quit(const Action &action)
+{
+	if (!action.is_start()) { return; }
+
+	on_end();
 }
 
-void Scene_Menu::s_render()
+void Scene_Menu::s_render(Render_List &list)
 {
-	m_game->window().clear(sf::Color(51, 51, 255));
+	list.clear_color= sf::Color(51, 51, 255);
+	list.view_center= sf::Vector2f(width() / 2.0f, height() / 2.0f);
+	list.view_size= sf::Vector2f((float)width(), (float)height());
 
-	m_menu_text.setString(m_title);
-	m_menu_text.setCharacterSize(64);
-	m_menu_text.setPosition(5, 8);
-	m_game->window().draw(m_menu_text);
+	list.text(e_Layer::Overlay, e_Font::Mario, 64, sf::Color(0, 0, 0), sf::Vector2f(5, 8), m_title);
 
-	m_menu_text.setPosition(5, 40);
+	float y= 40;
 	for (int i= 0; i < m_menu_strings.size(); i++)
 	{
-		m_menu_text.setString(m_menu_strings[i]);
-		m_menu_text.setPosition(5, m_menu_text.getPosition().y + 80);
-
-		if (i == m_menu_index)
-		{
-			m_menu_text.setFillColor(sf::Color(255, 255, 255));
-		}
-		else
-		{
-			m_menu_text.setFillColor(sf::Color(0, 0, 0));
-		}
-		m_game->window().draw(m_menu_text);
+		y+= 80;
+		sf::Color color= (i == m_menu_index) ? sf::Color(255, 255, 255) : sf::Color(0, 0, 0);
+		list.text(e_Layer::Overlay, e_Font::Mario, 64, color, sf::Vector2f(5, y), m_menu_strings[i]);
 	}
 
-	m_menu_text.setString("UP:W  DOWN:S  PLAY:D  BACK:ESC");
-	m_menu_text.setFillColor(sf::Color(0, 0, 0));
-	m_menu_text.setCharacterSize(24);
-	m_menu_text.setPosition(5, (int)height() - 64);
-	m_game->window().draw(m_menu_text);
+	list.text(e_Layer::Overlay, e_Font::Mario, 24, sf::Color(0, 0, 0), sf::Vector2f(5, (float)((int)height() - 64)), "UP:W  DOWN:S  PLAY:D  BACK:ESC");
 }
\ No newline at end of file
@@ -12,17 +12,21 @@ class Scene_Menu : public Scene
 	StringsVec	m_menu_strings;
 	StringsVec	m_level_paths;
 	int			m_menu_index= 0;
-	sf::Text	m_menu_text;
+	int			m_preloaded_index= -1;
 
 	void initialize();
 
 	virtual void on_end();
+
+	void a_up(const Action &action);
+	void a_down(const Action &action);
+	void a_play(const Action &action);
+	void a_quit(const Action &action);
 	
 public:
 	
 	Scene_Menu(Game_Engine *game_engine);
 
 	virtual void update();
-	virtual void s_do_action(const Action &action);
-	virtual void s_render();
+	virtual void s_render(Render_List &list);
 };
\ No newline at end of file
@@ -5,39 +5,79 @@
 #include "Game_Engine.h"
 #include "Components.h"
 #include "Action.h"
+#include "Alloc_Tracker.h"
+#include "Trace.h"
 
-Scene_Play::Scene_Play(Game_Engine *game_engine, const std::string &level_path)
-	: Scene(game_engine)
+#include <cmath>
+
+Scene_Play::Scene_Play(Game_Engine *game_engine, const std::string &level_path, size_t width, size_t height)
+	: Scene(game_engine, width, height)
 	, m_level_path(level_path)
+	, m_prefabs(game_engine->prefabs())
 {
 	initialize(m_level_path);
 }
 
-void Scene_Play::initialize(const std::string &level_path)
+Scene_Play::Scene_Play(const Assets &assets, const Prefab_Library &prefabs, const std::string &level_path, size_t width, size_t height)
+	: Scene(assets, width, height)
+	, m_level_path(level_path)
+	, m_prefabs(prefabs)
+{
+	initialize(m_level_path);
+}
+
+// builds a fresh copy of a level, safe to run on a loading thread since it only reads the
+// assets. The window is not thread safe, so its size is read here, when the load starts
+Scene_Builder Scene_Play::builder(Game_Engine *game_engine, const std::string &level_path)
 {
-	register_action(sf::Keyboard::P, "PAUSE");
-	register_action(sf::Keyboard::Escape, "QUIT");
-	register_action(sf::Keyboard::T, "TOGGLE_TEXTURE");		// Toggle drawing (T)extures
-	register_action(sf::Keyboard::C, "TOGGLE_COLLISION");	// Toggle drawing (C)ollision Boxes
-	register_action(sf::Keyboard::G, "TOGGLE_GRID");		// Toggle drawing (G)rid
+	sf::Vector2u size= game_engine->window().getSize();
+	return [game_engine, level_path, size]() { return std::make_shared<Scene_Play>(game_engine, level_path, size.x, size.y); };
+}
 
-	register_action(sf::Keyboard::D, "RIGHT");				// Toggle the player's right input
-	register_action(sf::Keyboard::A, "LEFT");
-	register_action(sf::Keyboard::W, "JUMP");
-	register_action(sf::Keyboard::Space, "SHOOT");
+void Scene_Play::initialize(const std::string &level_path)
+{
+	register_action(sf::Keyboard::P, e_Action::Pause, &Scene_Play::a_pause);
+	register_action(sf::Keyboard::Escape, e_Action::Quit, &Scene_Play::a_quit);
+	register_action(sf::Keyboard::T, e_Action::Toggle_Texture, &Scene_Play::a_toggle_texture);		// Toggle drawing (T)extures
+	register_action(sf::Keyboard::C, e_Action::Toggle_Collision, &Scene_Play::a_toggle_collision);	// Toggle drawing (C)ollision Boxes
+	register_action(sf::Keyboard::G, e_Action::Toggle_Grid, &Scene_Play::a_toggle_grid);			// Toggle drawing (G)rid
+	register_action(sf::Keyboard::R, e_Action::Rewind, &Scene_Play::a_rewind);						// hold to (R)ewind
+
+	register_action(sf::Keyboard::D, e_Action::Right, &Scene_Play::a_right);						// Toggle the player's right input
+	register_action(sf::Keyboard::A, e_Action::Left, &Scene_Play::a_left);
+	register_action(sf::Keyboard::W, e_Action::Jump, &Scene_Play::a_jump);
+	register_action(sf::Keyboard::Space, e_Action::Shoot, &Scene_Play::a_shoot);
+
+	// the most hits the projectiles can report in one frame, see Projectile_System::collide
+	m_events.reserve<Bullet_Hit_Tile>(m_projectiles.capacity());
+	m_events.reserve<Bullet_Hit_Enemy>(m_projectiles.capacity() * Projectile_System::max_pierce());
+
+	// 10 seconds of rewind, in at most 8 MB of undo records
+	if (!headless())
+	{
+		m_rewind= Rewind_Buffer(600, 8 << 20);
+	}
 
-	m_grid_text.setCharacterSize(12);
-	m_grid_text.setFont(m_game->assets().get_font("Arial"));
+	// the player and the enemies are copies of prefabs, the library is read once and
+	// copied into each scene because the level file tunes it
+	m_player_prefab= m_prefabs.id("Player");
+	m_goomba_prefab= m_prefabs.id("Goomba");
+	m_hunter_prefab= m_prefabs.id("Hunter");
+	if (m_player_prefab < 0)
+	{
+		std::cerr << "prefabs.txt has no Player prefab\n";
+		exit(-1);
+	}
 
 	load_level(level_path);
 }
 
-c_Vec2 Scene_Play::grid_to_mid_pixel(float gridX, float gridY, std::shared_ptr<Entity> entity)
+c_Vec2 Scene_Play::grid_to_mid_pixel(float gridX, float gridY, const Entity &entity)
 {
 	// translates a grid position with cell sizes of 64 x 64 pixels to the pixel position
 
 	c_Vec2 position;
-	c_Vec2 entity_size= entity->get_component<c_Animation>().animation.get_size();
+	c_Vec2 entity_size= entity.get_component<c_Animation>().animation.get_size();
 
 	position.x= gridX * m_grid_size.x + entity_size.x / 2;
 	position.y= height() - (gridY * m_grid_size.y) - entity_size.y / 2; 
@@ -47,60 +87,211 @@ c_Vec2 Scene_Play::grid_to_mid_pixel(float gridX, float gridY, std::shared_ptr<E
 
 void Scene_Play::load_level(const std::string &file_name)
 {
-	// reset the entity manager every time we load a level
-	m_entity_manager= Entity_Manager();
+	TRACE_SCOPE("load_level");
+
+	// a reload hands everything the last load allocated back to the level arena, so
+	// whatever still points into the arena has to let go of it first
+	m_player.reset();
+	m_lifespan_timers.reset(m_current_frame, 256);
+	m_animation_timers.reset(m_animation_frame, 256);
+	reset_level_memory(m_level);
 
 	std::ifstream file(file_name);
 	std::string string;
+	int level_columns= 0;
 
 	while (file.good())
 	{
 		file >> string;
 
-		if (string == "Tile")
+		if (string == "Tile" || string == "Dec" || string == "Enemy" || string == "Hunter")
 		{
-			std::string texture;
-			c_Vec2 grid_pos;
+			level_record record;
+			bool hunter= string == "Hunter";
+			record.type= (string == "Tile") ? e_Record_Type::Tile : (string == "Dec") ? e_Record_Type::Dec : e_Record_Type::Enemy;
 
-			file >> texture >> grid_pos.x >> grid_pos.y;
+			file >> string >> record.grid_pos.x >> record.grid_pos.y;
 
-			auto tile= m_entity_manager.add_entity(e_Tag::Tile);
-			tile->add_component<c_Animation>(m_game->assets().get_animation(texture), true);
-			tile->add_component<c_Transform>(grid_to_mid_pixel(grid_pos.x, grid_pos.y, tile));
-			tile->add_component<c_Bounding_box>(m_game->assets().get_animation(texture).get_size());
-		}
-		else if (string == "Dec")
-		{
-			std::string texture;
-			c_Vec2 grid_pos;
+			// an enemy names its prefab, or just the animation of a goomba or a hunter
+			if (record.type == e_Record_Type::Enemy)
+			{
+				record.prefab= hunter ? -1 : m_prefabs.id(string);
+			}
+
+			if (record.prefab < 0)
+			{
+				e_Animation animation= Assets::animation_id(string);
+				if (animation == e_Animation::Count)
+				{
+					std::cerr << "Unknown animation in level: " << string << std::endl;
+					continue;
+				}
+				record.animation= &assets().get_animation(animation);
 
-			file >> texture >> grid_pos.x >> grid_pos.y;
+				if (record.type == e_Record_Type::Enemy)
+				{
+					record.prefab= hunter ? m_hunter_prefab : m_goomba_prefab;
+					if (record.prefab < 0)
+					{
+						std::cerr << "No " << (hunter ? "Hunter" : "Goomba") << " prefab for " << string << std::endl;
+						continue;
+					}
+				}
+			}
 
-			auto dec= m_entity_manager.add_entity(e_Tag::Tile);
-			dec->add_component<c_Animation>(m_game->assets().get_animation(texture), true);
-			dec->add_component<c_Transform>(grid_to_mid_pixel(grid_pos.x, grid_pos.y, dec));
+			level_columns= std::max(level_columns, (int)record.grid_pos.x + 1);
+			m_level->records.push_back(record);
 		}
 		else if (string == "Player")
 		{
 			file >> m_player_config.X >> m_player_config.Y >> m_player_config.CX >> m_player_config.CY 
 				>> m_player_config.SPEED >> m_player_config.JUMP >> m_player_config.MAXSPEED 
-				>> m_player_config.GRAVITY >> m_player_config.WEAPON;
+				>> m_player_config.GRAVITY >> string;
+
+			// the weapon is a firing mode, which shoots the Buster, or for a single shot
+			// per press the animation to shoot
+			m_player_config.WEAPON_MODE= Projectile_System::weapon_id(string);
+			m_player_config.WEAPON= e_Animation::Buster;
+			if (m_player_config.WEAPON_MODE == e_Weapon::Count)
+			{
+				m_player_config.WEAPON_MODE= e_Weapon::Buster;
+				m_player_config.WEAPON= Assets::animation_id(string);
+				if (m_player_config.WEAPON == e_Animation::Count)
+				{
+					std::cerr << "Unknown weapon: " << string << ", using Buster" << std::endl;
+					m_player_config.WEAPON= e_Animation::Buster;
+				}
+			}
+			m_projectiles.set_sprite(assets().get_animation(m_player_config.WEAPON));
+			m_projectiles.clear();
+			m_next_shot= 0;
+
+			Prefab &player= m_prefabs.get(m_player_prefab);
+			player.add<c_Bounding_box>(c_Vec2(m_player_config.CX, m_player_config.CY));
+			player.add<c_Gravity>(m_player_config.GRAVITY);
 
 			spawn_player();
 		}
 		else if (string == "Goomba")
 		{
-			file >> m_goomba_config.CX >> m_goomba_config.CY >> m_goomba_config.SPEED >> m_goomba_config.MAXSPEED >> m_goomba_config.GRAVITY;
+			// tunes the goomba prefab and every prefab built on it, the max speed is not used
+			float cx, cy, speed, max_speed, gravity;
+			file >> cx >> cy >> speed >> max_speed >> gravity;
+
+			for (int i= 0; i < (int)m_prefabs.size(); i++)
+			{
+				if (!m_prefabs.derives(i, m_goomba_prefab)) { continue; }
+
+				Prefab &prefab= m_prefabs.get(i);
+				prefab.add<c_Bounding_box>(c_Vec2(cx, cy));
+				prefab.add<c_Gravity>(gravity);
+				prefab.get<c_Transform>().velocity.x= -speed;
+			}
+		}
+		else if (string == "Pathing")
+		{
+			file >> m_pathing_config.SPEED >> m_pathing_config.JUMP;
+		}
+		else if (string == "Wake")
+		{
+			file >> m_wake_distance;
+		}
+		else if (string == "Stream")
+		{
+			file >> m_chunk_width;
+			m_streaming= true;
+		}
+	}
+
+	// without streaming the whole level is a single chunk that is spawned once
+	if (!m_streaming || m_chunk_width < 1)
+	{
+		m_streaming= false;
+		m_chunk_width= std::max(level_columns, 1);
+	}
+
+	// index the records by grid X so a chunk can be spawned without scanning the level
+	m_level->chunks.resize(level_columns / m_chunk_width + 1);
+	for (size_t i= 0; i < m_level->records.size(); i++)
+	{
+		int chunk= std::max(0, (int)m_level->records[i].grid_pos.x) / m_chunk_width;
+		m_level->chunks[chunk].push_back(i);
+	}
+
+	// the flags are found once here so collision never has to look through every tile for them
+	for (size_t i= 0; i < m_level->records.size(); i++)
+	{
+		const level_record &record= m_level->records[i];
+		if (record.type != e_Record_Type::Enemy && record.animation->get_id() == e_Animation::PoleTop)
+		{
+			m_level->flags.push_back(i);
 		}
-		else if (string == "Enemy")
+	}
+
+	m_first_chunk= 0;
+	m_last_chunk= -1;
+
+	// the navigation graph is only built, and only paid for, when the level has enemies
+	// that path. Jump reach comes from the first one's jump arc: the peak height gives
+	// the rows and the distance covered while in the air gives the columns
+	auto hunter= std::find_if(m_level->records.begin(), m_level->records.end(), [&](const level_record &record)
+	{
+		return record.prefab >= 0 && m_prefabs.get(record.prefab).has<c_Pathing>();
+	});
+	bool hunters= hunter != m_level->records.end();
+	float gravity= hunters ? m_prefabs.get(hunter->prefab).get<c_Gravity>().gravity : 0;
+	int jump_columns= 0;
+	int jump_rows= 0;
+	if (m_pathing_config.JUMP < 0 && gravity > 0)
+	{
+		float air_time= -2 * m_pathing_config.JUMP / gravity;
+		float peak= m_pathing_config.JUMP * m_pathing_config.JUMP / (2 * gravity);
+		jump_columns= (int)(m_pathing_config.SPEED * air_time / m_grid_size.x);
+		jump_rows= (int)(peak / m_grid_size.y);
+	}
+	m_nav_graph.reset(hunters ? level_columns : 0, (int)std::ceil(height() / m_grid_size.y), jump_columns, jump_rows);
+	m_flow_field.reset(m_nav_graph);
+	build_nav_graph();
+
+	m_tile_colliders.reset(level_columns, (int)std::ceil(height() / m_grid_size.y), m_grid_size, (float)height());
+	build_tile_colliders();
+
+	// the most chunks that can be loaded at once is the view plus the two chunks of
+	// spawn margin and two of despawn margin, reserve enough entities for the busiest
+	// such window (plus headroom) so streaming never allocates
+	int window_chunks= m_streaming ? (int)std::ceil(width() / (m_chunk_width * m_grid_size.x)) + 5 : (int)m_level->chunks.size();
+	size_t busiest_window= 0;
+	for (size_t first= 0; first < m_level->chunks.size(); first++)
+	{
+		size_t records= 0;
+		for (size_t chunk= first; chunk < std::min(m_level->chunks.size(), first + window_chunks); chunk++)
 		{
-			std::string enemy_type;
-			c_Vec2 grid_pos;
+			records+= m_level->chunks[chunk].size();
+		}
+		busiest_window= std::max(busiest_window, records);
+	}
+	m_entity_manager->reserve(busiest_window + 256);
 
-			file >> enemy_type >> grid_pos.x >> grid_pos.y;
+	// a snapshot never holds more entities than the manager has room for
+	m_rewind.clear();
+	if (!headless())
+	{
+		m_snapshot.reserve(Snapshot::PREFIX_SIZE + 256 + m_level->records.size() + m_projectiles.capacity() * Projectile_System::RECORD_SIZE
+						   + (busiest_window + 256) * Snapshot::RECORD_SIZE);
+		m_rewind.reserve(m_snapshot.capacity());
+	}
 
-			spawn_enemy(enemy_type, grid_pos);
+	if (!m_streaming)
+	{
+		for (auto &chunk : m_level->chunks)
+		{
+			spawn_records(chunk);
 		}
+		m_last_chunk= (int)m_level->chunks.size() - 1;
+	}
+	else
+	{
+		s_streaming();
 	}
 
 	// NOTE: THIS IS INCREDIBLY IMPORTANT PLEASE READ THIS EXAMPLE
@@ -119,72 +310,490 @@ void Scene_Play::load_level(const std::string &file_name)
 
 void Scene_Play::spawn_player()
 {
-	m_player= m_entity_manager.add_entity(e_Tag::Player);
-	m_player->add_component<c_Animation>(m_game->assets().get_animation("Stand"), true);
-	m_player->add_component<c_Transform>(grid_to_mid_pixel(m_player_config.X, m_player_config.Y, m_player));
-	m_player->add_component<c_Bounding_box>(c_Vec2(m_player_config.CX, m_player_config.CY));
-	m_player->add_component<c_Input>();
-	m_player->add_component<c_Gravity>(m_player_config.GRAVITY);
-	m_player->add_component<c_State>("standing");
+	m_player= m_entity_manager->add_entity(m_prefabs.get(m_player_prefab));
+	place(*m_player, c_Vec2(m_player_config.X, m_player_config.Y));
 }
 
-void Scene_Play::spawn_bullet(std::shared_ptr<Entity> entity)
+// starts a prefab copy's animation and lifespan now and stands it on a grid position
+void Scene_Play::place(Entity &entity, const c_Vec2 &grid_pos)
 {
-	if (m_player->get_component<c_Input>().can_shoot)
-	{
-		c_Vec2 player_position= entity->get_component<c_Transform>().position;
+	auto &transform= entity.get_component<c_Transform>();
+	transform.position= grid_to_mid_pixel(grid_pos.x, grid_pos.y, entity);
+	transform.previous_position= transform.position;
+
+	entity.get_component<c_Animation>().animation.start(m_animation_frame);
+	entity.get_component<c_Lifespan>().frame_created= (int)m_current_frame;
 
-		auto bullet= m_entity_manager.add_entity(e_Tag::Bullet);
-		bullet->add_component<c_Animation>(m_game->assets().get_animation(m_player_config.WEAPON), true);
-		bullet->add_component<c_Transform>(player_position);
-		bullet->get_component<c_Transform>().velocity= c_Vec2(10 * entity->get_component<c_Transform>().scale.x, 0);
-		bullet->add_component<c_Bounding_box>(m_game->assets().get_animation(m_player_config.WEAPON).get_size());
-		bullet->add_component<c_Lifespan>(180, m_current_frame);
+	if (entity.has_component<c_Lifespan>() || !entity.get_component<c_Animation>().repeat)
+	{
+		schedule_timers(entity.shared_from_this());
 	}
 }
 
-void Scene_Play::spawn_coin(std::shared_ptr<Entity> question)
+// shoots a volley from the player the way they are facing
+void Scene_Play::fire_weapon()
+{
+	auto &transform= m_player->get_component<c_Transform>();
+	m_projectiles.fire(m_player_config.WEAPON_MODE, transform.position, transform.scale.x, m_current_frame);
+	m_next_shot= m_current_frame + Projectile_System::weapon(m_player_config.WEAPON_MODE).cooldown;
+	play_sound(e_Sound::Shoot);
+}
+
+void Scene_Play::spawn_coin(Entity &question)
 {
-	c_Vec2 question_pos= question->get_component<c_Transform>().position;
+	c_Vec2 question_pos= question.get_component<c_Transform>().position;
 	c_Vec2 coin_pos= question_pos;
 	coin_pos.y-= 64;
 
 
-	auto coin= m_entity_manager.add_entity(e_Tag::Dec);
-	coin->add_component<c_Animation>(m_game->assets().get_animation("Coin"), false);
-	coin->add_component<c_Transform>(coin_pos);
+	m_particles.spawn(e_Effect::Coin, coin_pos, c_Vec2(0, 0), 0, m_animation_frame);
 }
 
-void Scene_Play::spawn_enemy(std::string enemy_type, c_Vec2 grid_pos)
+// one bulk copy of an enemy prefab for a run of level records that share it
+void Scene_Play::spawn_enemies(const size_t *indices, size_t count)
 {
-	
-	auto enemy= m_entity_manager.add_entity(e_Tag::Enemy);
-	enemy->add_component<c_Animation>(m_game->assets().get_animation(enemy_type), true);
-	enemy->add_component<c_Transform>(grid_to_mid_pixel(grid_pos.x, grid_pos.y, enemy));
-	enemy->get_component<c_Transform>().velocity= c_Vec2(-m_goomba_config.SPEED, 0);
-	enemy->add_component<c_Bounding_box>(c_Vec2(m_goomba_config.CX, m_goomba_config.CY));
-	enemy->add_component<c_Gravity>(m_goomba_config.GRAVITY);
+	const Prefab &prefab= m_prefabs.get(m_level->records[indices[0]].prefab);
+
+	m_entity_manager->add_entities(prefab, count, [&](Entity &enemy, size_t i)
+	{
+		auto &record= m_level->records[indices[i]];
+
+		// an enemy given by its animation looks like that instead of its prefab
+		if (record.animation)
+		{
+			enemy.add_component<c_Animation>(*record.animation, true, m_animation_frame);
+		}
+		place(enemy, record.grid_pos);
+		enemy.add_component<c_Streamed>(indices[i], std::max(0, (int)record.grid_pos.x) / m_chunk_width);
+		record.live= true;
+	});
+}
+
+// spawns every record in the list that is not alive or destroyed, in order. Runs of
+// enemies from the same prefab are spawned together
+void Scene_Play::spawn_records(const std::pmr::vector<size_t> &indices)
+{
+	for (size_t i= 0; i < indices.size();)
+	{
+		const level_record &record= m_level->records[indices[i]];
+		if (record.type != e_Record_Type::Enemy || !spawnable(record))
+		{
+			spawn_record(indices[i]);
+			i++;
+			continue;
+		}
+
+		size_t run= 1;
+		while (i + run < indices.size())
+		{
+			const level_record &next= m_level->records[indices[i + run]];
+			if (next.type != e_Record_Type::Enemy || next.prefab != record.prefab || !spawnable(next)) { break; }
+			run++;
+		}
+
+		spawn_enemies(indices.data() + i, run);
+		i+= run;
+	}
+}
+
+bool Scene_Play::spawnable(const level_record &record) const
+{
+	return !record.live && record.state != e_Record_State::Destroyed;
+}
+
+// spawns the entity described by a level record, unless it was destroyed or is already alive
+void Scene_Play::spawn_record(size_t index)
+{
+	auto &record= m_level->records[index];
+
+	if (!spawnable(record)) { return; }
+
+	if (record.type == e_Record_Type::Enemy)
+	{
+		spawn_enemies(&index, 1);
+		return;
+	}
+
+	// a question block that was already hit comes back spent
+	const Animation &animation= (record.state == e_Record_State::Spent) ? assets().get_animation(e_Animation::Question2) : *record.animation;
+
+	auto entity= m_entity_manager->add_entity(e_Tag::Tile);
+	entity->add_component<c_Animation>(animation, true, m_animation_frame);
+	entity->add_component<c_Transform>(grid_to_mid_pixel(record.grid_pos.x, record.grid_pos.y, *entity));
+
+	// a merged tile collides through its collider instead of a box of its own
+	if (merges(record))
+	{
+		m_tile_colliders.set_tile((int)record.grid_pos.x, (int)record.grid_pos.y, entity.get());
+	}
+	else if (record.type == e_Record_Type::Tile)
+	{
+		entity->add_component<c_Bounding_box>(animation.get_size());
+	}
+
+	entity->add_component<c_Streamed>(index, std::max(0, (int)record.grid_pos.x) / m_chunk_width);
+	record.live= true;
+}
 
+// removes a streamed entity from the world while remembering its record can be spawned again
+void Scene_Play::despawn(std::shared_ptr<Entity> entity)
+{
+	if (entity->has_component<c_Streamed>())
+	{
+		auto &record= m_level->records[entity->get_component<c_Streamed>().record];
+		record.live= false;
+
+		if (merges(record))
+		{
+			m_tile_colliders.set_tile((int)record.grid_pos.x, (int)record.grid_pos.y, nullptr);
+		}
+	}
+	entity->destroy();
+}
+
+// records a permanent change to a streamed entity so it survives being despawned
+void Scene_Play::set_record_state(Entity &entity, e_Record_State state)
+{
+	if (entity.has_component<c_Streamed>())
+	{
+		auto &record= m_level->records[entity.get_component<c_Streamed>().record];
+		record.state= state;
+
+		if (state == e_Record_State::Destroyed)
+		{
+			record.live= false;
+		}
+	}
+}
+
+float Scene_Play::camera_x()
+{
+	// the view follows the player once they are far enough right
+	return std::max(width() / 2.0f, m_player->get_component<c_Transform>().position.x);
 }
 
 void Scene_Play::update()
 {
+	TRACE_SCOPE("Scene_Play::update");
+
+	if (m_rewinding)
+	{
+		s_rewind();
+		if (!headless()) { s_render(m_game->render_list()); }
+		return;
+	}
+
 	m_current_frame++;
-	m_entity_manager.update();
 
+	// start building the copy a restart will swap to, so dying never waits on the level file
+	if (m_current_frame == 1 && !headless())
+	{
+		m_game->preload_scene(m_level_path, builder(m_game, m_level_path));
+	}
+
+	s_streaming();
+	m_entity_manager->update();
+
+	// a paused frame changes nothing, so it is not recorded either
 	if (!m_paused)
 	{
+		s_snapshot();
+		s_activation();
+		s_pathing();
 		s_movement();
+		s_projectiles();
 		s_lifespan();
 		s_animation();
+		s_particles();
 	}
 
 	s_collision();
-	s_render();
+	s_tile_events();
+	s_combat_events();
+	s_level_events();
+
+	if (!headless())
+	{
+		s_render(m_game->render_list());
+	}
+}
+
+// serializes the scene into one contiguous buffer, see Snapshot.h for the layout
+void Scene_Play::save_snapshot(Snapshot_Bytes &bytes)
+{
+	bytes.clear();
+	Snapshot::Writer writer(bytes);
+
+	writer.write<uint32_t>(0);
+	writer.write<uint32_t>((uint32_t)Snapshot::RECORD_SIZE);
+	writer.write<uint32_t>(0);
+
+	writer.write<uint64_t>(m_current_frame);
+	writer.write<uint64_t>(m_entity_manager->total_entities());
+	writer.write<uint64_t>(m_animation_frame);
+
+	writer.write(m_player_config.X);
+	writer.write(m_player_config.Y);
+	writer.write(m_player_config.CX);
+	writer.write(m_player_config.CY);
+	writer.write(m_player_config.SPEED);
+	writer.write(m_player_config.MAXSPEED);
+	writer.write(m_player_config.JUMP);
+	writer.write(m_player_config.GRAVITY);
+	writer.write<uint16_t>((uint16_t)m_player_config.WEAPON);
+	writer.write<uint8_t>((uint8_t)m_player_config.WEAPON_MODE);
+	writer.write<uint64_t>(m_next_shot);
+
+	writer.write(m_pathing_config.SPEED);
+	writer.write(m_pathing_config.JUMP);
+
+	writer.write<int32_t>(m_first_chunk);
+	writer.write<int32_t>(m_last_chunk);
+	for (auto &record : m_level->records)
+	{
+		writer.write<uint8_t>((uint8_t)record.state | (record.live ? 1 << 2 : 0));
+	}
+	m_projectiles.save(writer);
+	writer.patch_u32(0, (uint32_t)(writer.size() - Snapshot::PREFIX_SIZE));
+
+	for (auto &e : m_entity_manager->get_entities())
+	{
+		writer.write_entity(*e);
+	}
+	writer.patch_u32(8, (uint32_t)m_entity_manager->get_entities().size());
+}
+
+// replaces every entity and all scene state with what the snapshot holds
+void Scene_Play::load_snapshot(const Snapshot_Bytes &bytes)
+{
+	Snapshot::Reader reader(bytes);
+
+	reader.read<uint32_t>();
+	reader.read<uint32_t>();
+	uint32_t entity_count= reader.read<uint32_t>();
+
+	// the snapshot is taken once the frame has started, so the next update
+	// has to land on the same frame again
+	m_current_frame=  reader.read<uint64_t>() - 1;
+	size_t total_entities= reader.read<uint64_t>();
+	m_animation_frame=	   reader.read<uint64_t>();
+
+	m_player_config.X=			reader.read<float>();
+	m_player_config.Y=			reader.read<float>();
+	m_player_config.CX=			reader.read<float>();
+	m_player_config.CY=			reader.read<float>();
+	m_player_config.SPEED=		reader.read<float>();
+	m_player_config.MAXSPEED=	reader.read<float>();
+	m_player_config.JUMP=		reader.read<float>();
+	m_player_config.GRAVITY=	reader.read<float>();
+	m_player_config.WEAPON=		(e_Animation)reader.read<uint16_t>();
+	m_player_config.WEAPON_MODE= (e_Weapon)reader.read<uint8_t>();
+	m_next_shot=				reader.read<uint64_t>();
+
+	m_pathing_config.SPEED=		reader.read<float>();
+	m_pathing_config.JUMP=		reader.read<float>();
+
+	m_first_chunk= reader.read<int32_t>();
+	m_last_chunk=  reader.read<int32_t>();
+	for (auto &record : m_level->records)
+	{
+		uint8_t bits= reader.read<uint8_t>();
+		record.state= (e_Record_State)(bits & 3);
+		record.live=  (bits & 1 << 2) != 0;
+	}
+	m_projectiles.load(reader);
+
+	// the keys held right now win over the ones held when the snapshot was taken
+	c_Input input= m_player->get_component<c_Input>();
+
+	m_lifespan_timers.clear(m_current_frame);
+	m_animation_timers.clear(m_animation_frame);
+	m_entity_manager->clear(total_entities);
+	for (uint32_t i= 0; i < entity_count; i++)
+	{
+		schedule_timers(reader.read_entity(*m_entity_manager, assets()));
+	}
+
+	m_player= m_entity_manager->get_entities(e_Tag::Player).front();
+	m_player->add_component<c_Input>(input);
+
+	// queued events point at entities that no longer exist, and effects are not recorded
+	m_events.clear();
+	m_particles.clear();
+
+	// bricks may have come back, the graph is rebuilt once play resumes, and the
+	// colliders right away since the tiles they point at were just replaced
+	m_nav_dirty= true;
+	build_tile_colliders();
+}
+
+// records this frame so it can be rewound to later
+void Scene_Play::s_snapshot()
+{
+	ALLOC_SCOPE("s_snapshot");
+	TRACE_SCOPE("s_snapshot");
+
+	if (headless()) { return; }
+
+	save_snapshot(m_snapshot);
+	m_rewind.push(m_snapshot);
+}
+
+// steps back one recorded frame while the rewind key is held
+void Scene_Play::s_rewind()
+{
+	ALLOC_SCOPE("s_rewind");
+	TRACE_SCOPE("s_rewind");
+
+	if (m_rewind.pop(m_snapshot))
+	{
+		load_snapshot(m_snapshot);
+	}
+}
+
+void Scene_Play::s_streaming()
+{
+	ALLOC_SCOPE("s_streaming");
+	TRACE_SCOPE("s_streaming");
+
+	if (!m_streaming) { return; }
+
+	float chunk_pixels= m_chunk_width * m_grid_size.x;
+	float view_left= camera_x() - width() / 2.0f;
+	float view_right= view_left + width();
+
+	// chunks are spawned one chunk ahead of the view, and only despawned once they
+	// are two chunks away so walking back and forth over a seam does not thrash
+	int last_chunk= (int)m_level->chunks.size() - 1;
+	int load_first= std::max(0, (int)std::floor(view_left / chunk_pixels) - 1);
+	int load_last= std::min(last_chunk, (int)std::floor(view_right / chunk_pixels) + 1);
+	int first= std::min(std::max(m_first_chunk, load_first - 1), load_first);
+	int last= std::max(std::min(m_last_chunk, load_last + 1), load_last);
+
+	if (m_last_chunk < m_first_chunk)
+	{
+		first= load_first;
+		last= load_last;
+	}
+
+	if (first != m_first_chunk || last != m_last_chunk)
+	{
+		for (auto &e : m_entity_manager->get_entities())
+		{
+			if (e->has_component<c_Streamed>() && e->tag() != e_Tag::Enemy)
+			{
+				int chunk= e->get_component<c_Streamed>().chunk;
+				if (chunk < first || chunk > last) { despawn(e); }
+			}
+		}
+
+		for (int chunk= first; chunk <= last; chunk++)
+		{
+			if (chunk < m_first_chunk || chunk > m_last_chunk)
+			{
+				spawn_records(m_level->chunks[chunk]);
+			}
+		}
+
+		m_first_chunk= first;
+		m_last_chunk= last;
+	}
+
+	// enemies walk away from the chunk they were spawned in, so they are
+	// despawned by where they are rather than where they came from
+	float loaded_left= m_first_chunk * chunk_pixels;
+	float loaded_right= (m_last_chunk + 1) * chunk_pixels;
+	for (auto &e : m_entity_manager->get_entities(e_Tag::Enemy))
+	{
+		float x= e->get_component<c_Transform>().position.x;
+		if (e->is_active() && (x < loaded_left || x > loaded_right)) { despawn(e); }
+	}
+}
+
+void Scene_Play::s_activation()
+{
+	ALLOC_SCOPE("s_activation");
+	TRACE_SCOPE("s_activation");
+
+	float view_left= camera_x() - width() / 2.0f - m_wake_distance * m_grid_size.x;
+	float view_right= view_left + width() + 2 * m_wake_distance * m_grid_size.x;
+
+	// wake any sleeping enemy that has come within range of the view
+	for (auto &e : m_entity_manager->get_entities(e_Tag::Enemy))
+	{
+		if (e->is_asleep())
+		{
+			float x= e->get_component<c_Transform>().position.x;
+			if (x >= view_left && x <= view_right) { m_entity_manager->wake(e); }
+		}
+	}
+}
+
+// steers every awake hunter along the flow field toward the player. The field is only
+// searched again when the player reaches another node or the tiles change, each hunter
+// then costs one look at the links out of the node it stands on
+void Scene_Play::s_pathing()
+{
+	ALLOC_SCOPE("s_pathing");
+	TRACE_SCOPE("s_pathing");
+
+	if (m_nav_graph.cells() == 0) { return; }
+
+	if (m_nav_dirty) { build_nav_graph(); }
+
+	auto column_of= [&](const c_Vec2 &position) { return (int)std::floor(position.x / m_grid_size.x); };
+	auto row_of= [&](const c_Vec2 &position) { return (int)std::floor((height() - position.y) / m_grid_size.y); };
+
+	// an airborne player is chased to the node under them, over a hole the old target stands
+	const c_Vec2 &player_position= m_player->get_component<c_Transform>().position;
+	int target= m_nav_graph.find_node(column_of(player_position), row_of(player_position));
+	m_flow_field.update(m_nav_graph, target >= 0 ? target : m_flow_field.target());
+
+	for (auto [e, transform, pathing] : m_entity_manager->awake_view<c_Transform, c_Pathing>())
+	{
+		int column= column_of(transform.position);
+		int row= row_of(transform.position);
+		bool arrived= false;
+
+		// links are only picked standing on a node, in the air the hunter keeps to the one it took
+		if (transform.velocity.y == 0 && m_nav_graph.is_node(column, row))
+		{
+			int cell= m_nav_graph.cell(column, row);
+			const Nav_Graph::link *next= m_flow_field.next(m_nav_graph, cell);
+
+			pathing.target= next ? (int)next->to : -1;
+			arrived= m_flow_field.cost(cell) == 0;
+
+			if (next && next->type == e_Nav_Link::Jump)
+			{
+				transform.velocity.y= m_pathing_config.JUMP;
+			}
+		}
+
+		// head for the middle of the next node, or straight at the player once on theirs,
+		// and with no way to the player just keep walking like a goomba
+		if (pathing.target >= 0 || arrived)
+		{
+			float goal= arrived ? player_position.x : (m_nav_graph.column(pathing.target) + 0.5f) * m_grid_size.x;
+			transform.velocity.x= std::clamp(goal - transform.position.x, -m_pathing_config.SPEED, m_pathing_config.SPEED);
+		}
+		else
+		{
+			transform.velocity.x= (transform.velocity.x < 0) ? -m_pathing_config.SPEED : m_pathing_config.SPEED;
+		}
+
+		if (transform.velocity.x != 0)
+		{
+			transform.scale.x= (transform.velocity.x < 0) ? 1.0f : -1.0f;
+		}
+	}
 }
 
 void Scene_Play::s_movement()
 {
+	ALLOC_SCOPE("s_movement");
+	TRACE_SCOPE("s_movement");
+
 	auto &player_transform= m_player->get_component<c_Transform>();
 	auto &player_input= m_player->get_component<c_Input>();
 
@@ -200,10 +809,11 @@ void Scene_Play::s_movement()
 	{
 		player_transform.velocity.y+= m_player_config.JUMP; 
 		m_player->get_component<c_Input>().can_jump= false;
+		play_sound(e_Sound::Jump);
 	}
 	// If the player is no inputting jump and moving upwards and not
 	// bouncing then the player's y velocity is set to 0 so they start falling
-	else if (!player_input.up && player_transform.velocity.y < 0 && m_player->get_component<c_State>().state != "bouncing")
+	else if (!player_input.up && player_transform.velocity.y < 0 && m_player->get_component<c_State>().state != e_State::Bouncing)
 	{
 		player_transform.velocity.y= 0.0f;
 	}
@@ -225,14 +835,13 @@ void Scene_Play::s_movement()
 	// adds gravity in the y direction if an entity has
 	// a gravity component
 	// sets the previous position and new position
-	for (auto &e : m_entity_manager.get_entities())
+	// sleeping entities never move, so only the active set is integrated
+	for (auto [e, transform, gravity] : m_entity_manager->awake_view<c_Transform, c_Gravity>())
+	{
+		transform.velocity.y+= gravity.gravity;
+	}
+	for (auto [e, transform] : m_entity_manager->awake_view<c_Transform>())
 	{
-		auto &transform= e->get_component<c_Transform>();
-
-		if (e->get_component<c_Gravity>().has)
-		{
-			transform.velocity.y+=e->get_component<c_Gravity>().gravity;
-		}
 		transform.previous_position= transform.position;
 		transform.position+= transform.velocity;
 	}
@@ -259,137 +868,152 @@ void Scene_Play::s_movement()
 
 void Scene_Play::s_lifespan()
 {
-	for (auto &e : m_entity_manager.get_entities())
+	ALLOC_SCOPE("s_lifespan");
+	TRACE_SCOPE("s_lifespan");
+
+	// only the entities whose lifespan runs out this frame are visited, the timer may
+	// outlive an entity that was destroyed some other way
+	m_lifespan_timers.advance(m_current_frame, [&](Entity &e, uint64_t)
 	{
-		if (e->get_component<c_Lifespan>().has)
+		if (e.is_active() && e.has_component<c_Lifespan>())
 		{
-			auto &lifespan= e->get_component<c_Lifespan>();
-			if (m_current_frame >= lifespan.frame_created + lifespan.lifespan)
+			auto &lifespan= e.get_component<c_Lifespan>();
+			if (m_current_frame >= (size_t)(lifespan.frame_created + lifespan.lifespan))
 			{
-				e->destroy();
+				e.destroy();
 			}
 		}
-	}
+	});
 }
 
+// detects collisions and resolves contacts, every gameplay consequence of a
+// collision is emitted as an event and handled by the event systems below
 void Scene_Play::s_collision()
 {
+	ALLOC_SCOPE("s_collision");
+	TRACE_SCOPE("s_collision");
+
 	c_Vec2 overlap;
 	c_Vec2 previous_overlap;
 
-	// bullet collisions
-	for (auto &b : m_entity_manager.get_entities(e_Tag::Bullet))
+	m_events.clear();
+
+	// projectile collisions, merged tiles are found through the grid cells a shot covers
+	// and the tiles and enemies with boxes of their own are filed by grid column
+	m_projectiles.clear_targets();
+	for (auto [e, transform, box] : m_entity_manager->view<c_Transform, c_Bounding_box>())
 	{
-		// Collisions with tiles
-		for (auto &t : m_entity_manager.get_entities(e_Tag::Tile))
+		if (e.tag() == e_Tag::Tile || e.tag() == e_Tag::Enemy)
 		{
-			overlap= Physics::get_overlap(b, t);
+			m_projectiles.add_target(e, transform.position, box.half_size, e.tag() == e_Tag::Tile);
+		}
+	}
+	m_projectiles.collide(m_tile_colliders,
+		[&](uint32_t projectile, Entity &tile)	{ m_events.emit(Bullet_Hit_Tile{ projectile, &tile }); },
+		[&](uint32_t projectile, Entity &enemy) { m_events.emit(Bullet_Hit_Enemy{ projectile, &enemy }); });
 
-			if (overlap.x > 0 && overlap.y > 0)
-			{
-				b->destroy();
+	// default state for player is air and can_jump set to false will
+	// adjust these states when certain collision conditions are met
+	if (m_player->get_component<c_State>().state != e_State::Bouncing)
+	{
+		m_player->get_component<c_State>().state= e_State::Air;
+	}
+	m_player->get_component<c_Input>().can_jump= false;
 
-				if (t->get_component<c_Animation>().animation.get_name() == "Brick")
-				{
-					t->add_component<c_Animation>(m_game->assets().get_animation("Explosion"), false);
-					t->remove_component<c_Bounding_box>();
-				}
+	// pushes the player out of a solid box they overlap, true when they hit it from below
+	auto push_player= [&](const c_Vec2 &position, const c_Vec2 &overlap, const c_Vec2 &previous_overlap)
+	{
+		bool from_below= false;
+
+		// If the overlap is horizontal
+		if (previous_overlap.y > 0)
+		{
+			// If the player came from the left, push them out to the left
+			if (m_player->get_component<c_Transform>().position.x < position.x)
+			{
+				m_player->get_component<c_Transform>().position.x-= overlap.x;
+			}
+			// If the player came from the right push them out to the right
+			else
+			{
+				m_player->get_component<c_Transform>().position.x+= overlap.x;
 			}
 		}
-		// Collisions with enemies
-		for (auto &e : m_entity_manager.get_entities(e_Tag::Enemy))
+		// If the overlap is vertical
+		if (previous_overlap.x > 0)
 		{
-			overlap= Physics::get_overlap(b, e);
-
-			if (overlap.x > 0 && overlap.y > 0)
+			// If the player comes from above, the player is then on the ground and can jump
+			if (m_player->get_component<c_Transform>().position.y < position.y)
 			{
-				b->destroy();
-
-				e->add_component<c_Animation>(m_game->assets().get_animation("Explosion"), false);
-				e->remove_component<c_Bounding_box>();
-				e->remove_component<c_Gravity>();
-				e->get_component<c_Transform>().velocity= c_Vec2(0, 0);
+				m_player->get_component<c_Transform>().position.y-= overlap.y;
+				m_player->get_component<c_State>().state= e_State::Ground;
+				m_player->get_component<c_Input>().can_jump= true;
+			}
+			// If the player comes from below
+			else
+			{
+				m_player->get_component<c_Transform>().position.y+= overlap.y;
+				from_below= true;
 			}
+
+			// Reset vertical speed upon vertical tile collisions
+			m_player->get_component<c_Transform>().velocity.y= 0.0;
 		}
-	}
 
-	// default state for player is air and can_jump set to false will
-	// adjust these states when certain collision conditions are met
-	if (m_player->get_component<c_State>().state != "bouncing")
-	{
-		m_player->get_component<c_State>().state= "air";
-	}
-	m_player->get_component<c_Input>().can_jump= false;
+		return from_below;
+	};
 
-	// Collisions between the player and tiles
-	for (auto &t : m_entity_manager.get_entities(e_Tag::Tile))
+	// Collisions between the player and merged tiles, bumping one from below bumps
+	// every tile of it the player was touching
+	for (auto &c : m_tile_colliders.colliders())
 	{
-		overlap= Physics::get_overlap(m_player, t);
+		overlap= Physics::get_overlap(m_player, c.position, c.half_size);
 
-		// If the two bounding boxes overlap
 		if (overlap.x > 0 && overlap.y > 0)
 		{
-			previous_overlap= Physics::get_previous_overlap(m_player, t);
+			previous_overlap= Physics::limit_push(overlap, Physics::get_previous_overlap(m_player, c.position, c.half_size),
+												  m_player->get_component<c_Bounding_box>().half_size + m_grid_size / 2);
+			c_Vec2 player_position= m_player->get_component<c_Transform>().position;
 
-			// If the overlap is horizontal
-			if (previous_overlap.y > 0)
+			if (push_player(c.position, overlap, previous_overlap))
 			{
-				// If the player came from the left, push them out to the left
-				if (m_player->get_component<c_Transform>().position.x < t->get_component<c_Transform>().position.x)
-				{
-					m_player->get_component<c_Transform>().position.x-= overlap.x;
-				}
-				// If the player came from the right push them out to the right
-				else
-				{
-					m_player->get_component<c_Transform>().position.x+= overlap.x;
-				}
+				m_tile_colliders.for_each_tile(c, player_position, m_player->get_component<c_Bounding_box>().half_size,
+											   [&](Entity &tile) { m_events.emit(Player_Bump_Tile{ &tile }); });
 			}
-			// If the overlap is vertical
-			if (previous_overlap.x > 0)
-			{
-				// If the player comes from above, the player is then on the ground and can jump
-				if (m_player->get_component<c_Transform>().position.y < t->get_component<c_Transform>().position.y)
-				{
-					m_player->get_component<c_Transform>().position.y-= overlap.y;
-					m_player->get_component<c_State>().state= "ground";
-					m_player->get_component<c_Input>().can_jump= true;
-				}
-				// If the player comes from below
-				else
-				{
-					m_player->get_component<c_Transform>().position.y+= overlap.y;
+		}
+	}
 
-					if (t->get_component<c_Animation>().animation.get_name() == "Question")
-					{
-						spawn_coin(t);
-						t->add_component<c_Animation>(m_game->assets().get_animation("Quest_Bounce"), false);
-					}
-					if (t->get_component<c_Animation>().animation.get_name() == "Brick")
-					{
-						t->add_component<c_Animation>(m_game->assets().get_animation("Explosion"), false);
-						t->remove_component<c_Bounding_box>();
-					}
-				}
+	// if the player passes a flag that is spawned then reset the level
+	for (size_t index : m_level->flags)
+	{
+		const level_record &record= m_level->records[index];
+		float flag_x= record.grid_pos.x * m_grid_size.x + record.animation->get_size().x / 2;
 
-				// Reset vertical speed upon vertical tile collisions
-				m_player->get_component<c_Transform>().velocity.y= 0.0;
-			}
-			
+		if (record.live && m_player->get_component<c_Transform>().position.x > flag_x)
+		{
+			m_events.emit(Flag_Reached{ index });
 		}
+	}
+
+	// Collisions between the player and the few tiles too big or off grid to be merged
+	for (auto [t, transform, box] : m_entity_manager->view<c_Transform, c_Bounding_box>(e_Tag::Tile))
+	{
+		overlap= Physics::get_overlap(m_player, transform.position, box.half_size);
 
-		// if the player passes the flag then reset the level
-		if (t->get_component<c_Animation>().animation.get_name() == "PoleTop")
+		// If the two bounding boxes overlap
+		if (overlap.x > 0 && overlap.y > 0)
 		{
-			if (m_player->get_component<c_Transform>().position.x > t->get_component<c_Transform>().position.x)
+			previous_overlap= Physics::get_previous_overlap(m_player, transform.previous_position, box.half_size);
+
+			if (push_player(transform.position, overlap, previous_overlap))
 			{
-				m_game->change_scene("PLAY", std::make_shared<Scene_Play>(m_game, m_level_path));
+				m_events.emit(Player_Bump_Tile{ &t });
 			}
 		}
 	}
 
-	// Enemy collisions
-	for (auto &e : m_entity_manager.get_entities(e_Tag::Enemy))
+	// Enemy collisions, sleeping enemies are too far from the view to matter
+	for (auto &e : m_entity_manager->get_awake_entities(e_Tag::Enemy))
 	{
 		// Enemy collisions with the player
 		overlap= Physics::get_overlap(m_player, e);
@@ -405,87 +1029,92 @@ void Scene_Play::s_collision()
 				// If the player comes from above destroy the enemy
 				if (m_player->get_component<c_Transform>().position.y < e->get_component<c_Transform>().position.y)
 				{
-					m_player->get_component<c_Transform>().velocity.y= -10.0f;
-					m_player->get_component<c_State>().state= "bouncing";
-					e->add_component<c_Animation>(m_game->assets().get_animation("GoombaSquash"), false);
-					e->remove_component<c_Bounding_box>();
-					e->remove_component<c_Gravity>();
-					e->get_component<c_Transform>().velocity= c_Vec2(0, 0);
-
+					m_events.emit(Player_Stomp{ e.get() });
 				}
 				// If from below then respawn the player by resetting the scene
 				else
 				{
-					m_game->change_scene("PLAY", std::make_shared<Scene_Play>(m_game, m_level_path));
+					m_events.emit(Player_Hurt{ e.get() });
 				}
 			}
 			// If the overlap is horizontal, respawn the player by resetting the scene
 			if (previous_overlap.y > 0)
 			{
-				m_game->change_scene("PLAY", std::make_shared<Scene_Play>(m_game, m_level_path));
+				m_events.emit(Player_Hurt{ e.get() });
 			}
 		}
 
-		// Collisions between enemies and tiles
-		for (auto &t : m_entity_manager.get_entities(e_Tag::Tile))
+		// pushes the enemy out of a solid box, turning it around when it walks into one
+		auto push_enemy= [&](const c_Vec2 &position, const c_Vec2 &overlap, const c_Vec2 &previous_overlap)
 		{
-			overlap= Physics::get_overlap(e, t);
-
-			// If the bounding boxes overlap
-			if (overlap.x > 0 && overlap.y > 0)
+			// If the overlap is horizontal
+			if (previous_overlap.y > 0)
 			{
-				previous_overlap= Physics::get_previous_overlap(e, t);
-
-				// If the overlap is horizontal
-				if (previous_overlap.y > 0)
+				if (e->get_component<c_Transform>().position.x < position.x)
 				{
-					if (e->get_component<c_Transform>().position.x < t->get_component<c_Transform>().position.x)
-					{
-						e->get_component<c_Transform>().position.x-= overlap.x;
-					}
-					else
-					{
-						e->get_component<c_Transform>().position.x+= overlap.x;
-					}
-
-					// Turn the enemy around when it hits a wall
-					e->get_component<c_Transform>().velocity.x= -e->get_component<c_Transform>().velocity.x;
-					e->get_component<c_Transform>().scale.x*= -1;
+					e->get_component<c_Transform>().position.x-= overlap.x;
 				}
-				// If the overlap is vertical
-				if (previous_overlap.x > 0)
+				else
 				{
-					if (e->get_component<c_Transform>().position.y < t->get_component<c_Transform>().position.y)
-					{
-						e->get_component<c_Transform>().position.y-= overlap.y;
-					}
-					else
-					{
-						e->get_component<c_Transform>().position.y+= overlap.y;
-					}
+					e->get_component<c_Transform>().position.x+= overlap.x;
+				}
 
-					e->get_component<c_Transform>().velocity.y= 0.0;
+				// Turn the enemy around when it hits a wall
+				e->get_component<c_Transform>().velocity.x= -e->get_component<c_Transform>().velocity.x;
+				e->get_component<c_Transform>().scale.x*= -1;
+			}
+			// If the overlap is vertical
+			if (previous_overlap.x > 0)
+			{
+				if (e->get_component<c_Transform>().position.y < position.y)
+				{
+					e->get_component<c_Transform>().position.y-= overlap.y;
+				}
+				else
+				{
+					e->get_component<c_Transform>().position.y+= overlap.y;
 				}
+
+				e->get_component<c_Transform>().velocity.y= 0.0;
+			}
+		};
+
+		// Collisions between enemies and merged tiles
+		for (auto &c : m_tile_colliders.colliders())
+		{
+			overlap= Physics::get_overlap(e, c.position, c.half_size);
+
+			if (overlap.x > 0 && overlap.y > 0)
+			{
+				previous_overlap= Physics::limit_push(overlap, Physics::get_previous_overlap(e, c.position, c.half_size),
+													  e->get_component<c_Bounding_box>().half_size + m_grid_size / 2);
+				push_enemy(c.position, overlap, previous_overlap);
 			}
 		}
 
-		// If the enemy falls down a hole, the enemy dies
-		if (e->get_component<c_Transform>().position.y > height())
+		// Collisions between enemies and the tiles that were not merged
+		for (auto [t, transform, box] : m_entity_manager->view<c_Transform, c_Bounding_box>(e_Tag::Tile))
 		{
-			e->destroy();
+			overlap= Physics::get_overlap(e, transform.position, box.half_size);
+
+			// If the bounding boxes overlap
+			if (overlap.x > 0 && overlap.y > 0)
+			{
+				push_enemy(transform.position, overlap, Physics::get_previous_overlap(e, transform.previous_position, box.half_size));
+			}
 		}
 
-		// If the enemy leaves the left bounds of the map, the enemy dies
-		if (e->get_component<c_Transform>().position.x < 0)
+		// If the enemy falls down a hole, or leaves the left bounds of the map, the enemy dies
+		if (e->get_component<c_Transform>().position.y > height() || e->get_component<c_Transform>().position.x < 0)
 		{
-			e->destroy();
+			m_events.emit(Enemy_Lost{ e.get() });
 		}
 	}
 	
 	// If the player falls down a hole, reset the level
 	if (m_player->get_component<c_Transform>().position.y > height())
 	{
-		m_game->change_scene("PLAY", std::make_shared<Scene_Play>(m_game, m_level_path));
+		m_events.emit(Player_Hurt{ nullptr });
 	}
 	
 	// If the player tries to leave the left bounds of the map it reset their position within the bounds
@@ -495,31 +1124,290 @@ void Scene_Play::s_collision()
 	}
 }
 
-void Scene_Play::s_do_action(const Action &action)
+// replaces a brick with an explosion and flying debris, the brick's record remembers it is gone
+void Scene_Play::explode_brick(Entity &tile)
+{
+	const c_Vec2 &position= tile.get_component<c_Transform>().position;
+	m_particles.spawn(e_Effect::Explosion, position, c_Vec2(0, 0), 0, m_animation_frame);
+	m_particles.spawn_debris(position, m_animation_frame);
+	play_sound(e_Sound::Brick);
+
+	if (tile.has_component<c_Streamed>())
+	{
+		auto &record= m_level->records[tile.get_component<c_Streamed>().record];
+		if (merges(record))
+		{
+			m_tile_colliders.remove((int)record.grid_pos.x, (int)record.grid_pos.y);
+		}
+	}
+
+	set_record_state(tile, e_Record_State::Destroyed);
+	tile.destroy();
+	m_nav_dirty= true;
+}
+
+// tiles one cell in size on whole cells are merged, anything bigger keeps its own box
+bool Scene_Play::merges(const level_record &record) const
+{
+	return record.type == e_Record_Type::Tile
+		&& record.animation->get_size().x == m_grid_size.x && record.animation->get_size().y == m_grid_size.y
+		&& record.grid_pos.x == std::floor(record.grid_pos.x) && record.grid_pos.y == std::floor(record.grid_pos.y);
+}
+
+// merges the tiles still standing into colliders and points every cell at its live tile
+void Scene_Play::build_tile_colliders()
+{
+	m_tile_colliders.clear_solid();
+	for (auto &record : m_level->records)
+	{
+		if (merges(record) && record.state != e_Record_State::Destroyed)
+		{
+			m_tile_colliders.set_solid((int)record.grid_pos.x, (int)record.grid_pos.y);
+		}
+	}
+	m_tile_colliders.build();
+
+	m_tile_colliders.clear_tiles();
+	for (auto &t : m_entity_manager->get_entities(e_Tag::Tile))
+	{
+		if (!t->is_active() || !t->has_component<c_Streamed>()) { continue; }
+
+		auto &record= m_level->records[t->get_component<c_Streamed>().record];
+		if (merges(record))
+		{
+			m_tile_colliders.set_tile((int)record.grid_pos.x, (int)record.grid_pos.y, t.get());
+		}
+	}
+}
+
+// sets the timers an entity's lifespan and one-shot animation need, for a new entity
+// or one restored from a snapshot
+void Scene_Play::schedule_timers(const std::shared_ptr<Entity> &entity)
 {
-	if (action.type() == "START")
+	if (entity->has_component<c_Lifespan>())
+	{
+		auto &lifespan= entity->get_component<c_Lifespan>();
+		m_lifespan_timers.schedule(lifespan.frame_created + lifespan.lifespan, entity);
+	}
+
+	if (entity->has_component<c_Animation>() && !entity->get_component<c_Animation>().repeat)
 	{
-			 if (action.name() == "TOGGLE_TEXTURE")		{ m_draw_textures= !m_draw_textures; }
-		else if (action.name() == "TOGGLE_COLLISION")	{ m_draw_collision= !m_draw_collision; }
-		else if (action.name() == "TOGGLE_GRID")		{ m_draw_grid= !m_draw_grid; }
-		else if (action.name() == "PAUSE")				{ set_paused(); }
-		else if (action.name() == "QUIT")				{ on_end(); }
-		else if (action.name() == "RIGHT")				{ m_player->get_component<c_Input>().right= true; }
-		else if (action.name() == "LEFT")				{ m_player->get_component<c_Input>().left= true; }
-		else if (action.name() == "JUMP")				{ m_player->get_component<c_Input>().up= true;}
-		else if (action.name() == "SHOOT")				{ spawn_bullet(m_player); m_player->get_component<c_Input>().can_shoot= false; }
+		m_animation_timers.schedule(entity->get_component<c_Animation>().animation.end_frame(), entity);
 	}
-	else if (action.type() == "END")
+}
+
+// plays an animation through once, s_animation acts when it ends
+void Scene_Play::play_once(Entity &entity, e_Animation animation)
+{
+	entity.add_component<c_Animation>(assets().get_animation(animation), false, m_animation_frame);
+	m_animation_timers.schedule(entity.get_component<c_Animation>().animation.end_frame(), entity.shared_from_this());
+}
+
+// marks every tile that is still standing on the navigation grid and relinks it
+void Scene_Play::build_nav_graph()
+{
+	m_nav_dirty= false;
+
+	if (m_nav_graph.cells() == 0) { return; }
+
+	m_nav_graph.clear_solid();
+	for (auto &record : m_level->records)
 	{
-		if (action.name() == "RIGHT")					{ m_player->get_component<c_Input>().right= false; }
-		if (action.name() == "LEFT")					{ m_player->get_component<c_Input>().left= false; }
-		if (action.name() == "JUMP")					{ m_player->get_component<c_Input>().up= false;   }
-		if (action.name() == "SHOOT")					{ m_player->get_component<c_Input>().can_shoot= true; }
+		if (record.type != e_Record_Type::Tile || record.state == e_Record_State::Destroyed) { continue; }
+
+		c_Vec2 size= record.animation->get_size();
+		m_nav_graph.set_solid((int)record.grid_pos.x, (int)record.grid_pos.y,
+							  (int)std::ceil(size.x / m_grid_size.x), (int)std::ceil(size.y / m_grid_size.y));
+	}
+	m_nav_graph.build();
+}
+
+void Scene_Play::s_tile_events()
+{
+	ALLOC_SCOPE("s_tile_events");
+	TRACE_SCOPE("s_tile_events");
+
+	// tile hits are resolved first, a shot stopped by a tile hits nothing else this frame
+	for (auto &event : m_events.get<Bullet_Hit_Tile>())
+	{
+		if (!m_projectiles.hit(event.projectile, true)) { continue; }
+
+		if (event.tile->is_active() && event.tile->get_component<c_Animation>().animation.get_id() == e_Animation::Brick)
+		{
+			explode_brick(*event.tile);
+		}
+	}
+
+	for (auto &event : m_events.get<Player_Bump_Tile>())
+	{
+		auto &tile= *event.tile;
+		e_Animation animation= tile.get_component<c_Animation>().animation.get_id();
+
+		if (animation == e_Animation::Question)
+		{
+			spawn_coin(tile);
+			play_once(tile, e_Animation::Quest_Bounce);
+			set_record_state(tile, e_Record_State::Spent);
+			play_sound(e_Sound::Coin);
+		}
+		else if (animation == e_Animation::Brick)
+		{
+			if (tile.is_active()) { explode_brick(tile); }
+		}
+		else
+		{
+			play_sound(e_Sound::Bump);
+		}
+	}
+}
+
+void Scene_Play::s_combat_events()
+{
+	ALLOC_SCOPE("s_combat_events");
+	TRACE_SCOPE("s_combat_events");
+
+	for (auto &event : m_events.get<Bullet_Hit_Enemy>())
+	{
+		auto &enemy= *event.enemy;
+		if (!m_projectiles.hit(event.projectile, false)) { continue; }
+
+		// two bullets can hit the same enemy on the same frame
+		if (!enemy.is_active()) { continue; }
+
+		m_particles.spawn(e_Effect::Explosion, enemy.get_component<c_Transform>().position, c_Vec2(0, 0), 0, m_animation_frame);
+		set_record_state(enemy, e_Record_State::Destroyed);
+		enemy.destroy();
+		play_sound(e_Sound::Kill);
+	}
+
+	for (auto &event : m_events.get<Player_Stomp>())
+	{
+		auto &enemy= *event.enemy;
+
+		m_player->get_component<c_Transform>().velocity.y= -10.0f;
+		m_player->get_component<c_State>().state= e_State::Bouncing;
+
+		if (!enemy.is_active()) { continue; }
+
+		m_particles.spawn(e_Effect::Squash, enemy.get_component<c_Transform>().position, c_Vec2(0, 0), 0, m_animation_frame);
+		set_record_state(enemy, e_Record_State::Destroyed);
+		enemy.destroy();
+		play_sound(e_Sound::Stomp);
+	}
+
+	for (auto &event : m_events.get<Enemy_Lost>())
+	{
+		set_record_state(*event.enemy, e_Record_State::Destroyed);
+		event.enemy->destroy();
+	}
+}
+
+void Scene_Play::s_level_events()
+{
+	ALLOC_SCOPE("s_level_events");
+	TRACE_SCOPE("s_level_events");
+
+	// getting hurt and reaching the flag both restart the level, once
+	bool hurt= !m_events.get<Player_Hurt>().empty();
+	if (hurt || !m_events.get<Flag_Reached>().empty())
+	{
+		if (!m_restarting) { play_sound(hurt ? e_Sound::Die : e_Sound::Flag); }
+		restart();
+	}
+}
+
+// a windowed scene is replaced by a fresh, usually preloaded, one. A headless scene
+// has no engine to do that so it reloads the level in place
+void Scene_Play::restart()
+{
+	if (!headless())
+	{
+		// the scene keeps running until the fresh copy is swapped in at a frame boundary
+		if (!m_restarting)
+		{
+			m_game->change_scene_async("PLAY", m_level_path, builder(m_game, m_level_path));
+			m_restarting= true;
+		}
+		return;
+	}
+
+	m_current_frame= 0;
+	m_paused= false;
+	m_rewinding= false;
+	m_events.clear();
+	m_particles.clear();
+	load_level(m_level_path);
+}
+
+// action handlers, toggles only act when the key goes down while held inputs
+// follow the key both ways
+void Scene_Play::a_toggle_texture(const Action &action)
+{
+	if (action.is_start()) { m_draw_textures= !m_draw_textures; }
+}
+
+void Scene_Play::a_toggle_collision(const Action &action)
+{
+	if (action.is_start()) { m_draw_collision= !m_draw_collision; }
+}
+
+void Scene_Play::a_toggle_grid(const Action &action)
+{
+	if (action.is_start()) { m_draw_grid= !m_draw_grid; }
+}
+
+void Scene_Play::a_pause(const Action &action)
+{
+	if (action.is_start()) { set_paused(); }
+}
+
+void Scene_Play::a_rewind(const Action &action)
+{
+	m_rewinding= action.is_start();
+}
+
+void Scene_Play::a_quit(const Action &action)
+{
+	if (action.is_start()) { on_end(); }
+}
+
+void Scene_Play::a_right(const Action &action)
+{
+	m_player->get_component<c_Input>().right= action.is_start();
+}
+
+void Scene_Play::a_left(const Action &action)
+{
+	m_player->get_component<c_Input>().left= action.is_start();
+}
+
+void Scene_Play::a_jump(const Action &action)
+{
+	m_player->get_component<c_Input>().up= action.is_start();
+}
+
+void Scene_Play::a_shoot(const Action &action)
+{
+	auto &input= m_player->get_component<c_Input>();
+	input.shoot= action.is_start();
+
+	if (action.is_start() && !m_rewinding)
+	{
+		// tapping a weapon with a cooldown fires no faster than holding it
+		if (input.can_shoot && m_current_frame >= m_next_shot) { fire_weapon(); }
+		input.can_shoot= false;
+	}
+	else if (!action.is_start())
+	{
+		input.can_shoot= true;
 	}
 }
 
 void Scene_Play::s_animation()
 {
+	ALLOC_SCOPE("s_animation");
+	TRACE_SCOPE("s_animation");
+
 	// Adding a component like this will override the existing component
 	/*
 	
@@ -529,137 +1417,141 @@ void Scene_Play::s_animation()
 
 	*/
 
-	//	for each entity with an animation, call entity->get_component<c_Animation>().animation.update()
+	//	the animation frame only advances while the game is not paused, so pausing freezes every animation
 	//	if the animation is not repeated, and it has ended, destroy the entity
-	std::string animation_name= m_player->get_component<c_Animation>().animation.get_name();
-	std::string player_state= m_player->get_component<c_State>().state;
+	m_animation_frame++;
 
-	if (player_state == "ground")
+	e_Animation player_animation= m_player->get_component<c_Animation>().animation.get_id();
+	e_State player_state= m_player->get_component<c_State>().state;
+
+	if (player_state == e_State::Ground)
 	{
-		if (m_player->get_component<c_Transform>().velocity.x != 0 && animation_name != "Run")
+		if (m_player->get_component<c_Transform>().velocity.x != 0 && player_animation != e_Animation::Run)
 		{
-			m_player->add_component<c_Animation>(m_game->assets().get_animation("Run"), true);
+			m_player->add_component<c_Animation>(assets().get_animation(e_Animation::Run), true, m_animation_frame);
 		}
-		else if (m_player->get_component<c_Transform>().velocity.x == 0 && animation_name != "Stand")
+		else if (m_player->get_component<c_Transform>().velocity.x == 0 && player_animation != e_Animation::Stand)
 		{
-			m_player->add_component<c_Animation>(m_game->assets().get_animation("Stand"), true);
+			m_player->add_component<c_Animation>(assets().get_animation(e_Animation::Stand), true, m_animation_frame);
 		}
 	}
-	else if (player_state == "air" && animation_name != "Air")
+	else if (player_state == e_State::Air && player_animation != e_Animation::Air)
 	{
-		m_player->add_component<c_Animation>(m_game->assets().get_animation("Air"), true);
+		m_player->add_component<c_Animation>(assets().get_animation(e_Animation::Air), true, m_animation_frame);
 	}
 
-	for (auto &e : m_entity_manager.get_entities())
+	// looping animations are a function of the animation frame and cost nothing here,
+	// one-shot animations fire a timer on the frame they have played through. The entity
+	// may have been destroyed or given another animation since the timer was set
+	m_animation_timers.advance(m_animation_frame, [&](Entity &e, uint64_t)
 	{
-		if (e->get_component<c_Animation>().has)
+		if (!e.is_active() || !e.has_component<c_Animation>()) { return; }
+
+		auto &animation= e.get_component<c_Animation>();
+		if (animation.repeat || !animation.animation.has_ended(m_animation_frame)) { return; }
+
+		if (animation.animation.get_id() == e_Animation::Quest_Bounce)
 		{
-			if (!e->get_component<c_Animation>().repeat && e->get_component<c_Animation>().animation.has_ended())
-			{
-				if (e->get_component<c_Animation>().animation.get_name() == "Quest_Bounce")
-				{
-					e->add_component<c_Animation>(m_game->assets().get_animation("Question2"), true);
-				}
-				else
-				{
-					e->destroy();
-				}
-			}
-			else
-			{
-				e->get_component<c_Animation>().animation.update();
-			}
+			e.add_component<c_Animation>(assets().get_animation(e_Animation::Question2), true, m_animation_frame);
+		}
+		else
+		{
+			e.destroy();
 		}
+	});
+}
+
+// a weapon with a cooldown keeps firing while the button is held, then every shot moves
+void Scene_Play::s_projectiles()
+{
+	ALLOC_SCOPE("s_projectiles");
+	TRACE_SCOPE("s_projectiles");
+
+	const weapon_config &weapon= Projectile_System::weapon(m_player_config.WEAPON_MODE);
+	if (weapon.cooldown > 0 && m_player->get_component<c_Input>().shoot && m_current_frame >= m_next_shot)
+	{
+		fire_weapon();
 	}
+
+	m_projectiles.update(m_current_frame);
 }
 
-void Scene_Play::on_end()
+void Scene_Play::s_particles()
 {
-	m_game->change_scene("MENU", nullptr, true);
+	ALLOC_SCOPE("s_particles");
+	TRACE_SCOPE("s_particles");
+
+	m_particles.update(m_animation_frame);
 }
 
-void Scene_Play::draw_line(const c_Vec2 &p1, const c_Vec2 &p2)
+void Scene_Play::on_end()
 {
-	sf::Vertex line[]={ sf::Vector2f(p1.x, p1.y), sf::Vector2f(p2.x, p2.y) };
-	m_game->window().draw(line, 2, sf::Lines);
+	if (headless())
+	{
+		m_has_ended= true;
+		return;
+	}
+	m_game->change_scene("MENU", nullptr, true);
 }
 
-void Scene_Play::s_render()
+// only records what to draw, a Render_Backend sorts, batches and draws it. In the game
+// that happens on the render thread while the next tick runs
+void Scene_Play::s_render(Render_List &list)
 {
+	ALLOC_SCOPE("s_render");
+	TRACE_SCOPE("s_render");
+
 	// color the background darker so you know that the game is paused
-	if (!m_paused) { m_game->window().clear(sf::Color(100, 100, 255)); }
-	else		   { m_game->window().clear(sf::Color(50, 50, 150)); }
+	list.clear_color= m_paused ? sf::Color(50, 50, 150) : sf::Color(100, 100, 255);
 
 	// set the viewpoint of the window to be centered on the player if it's far enough right
-	auto &player_position= m_player->get_component<c_Transform>().position;
-	float window_center_x= std::max(m_game->window().getSize().x / 2.0f, player_position.x);
-	sf::View view= m_game->window().getView();
-	view.setCenter(window_center_x, m_game->window().getSize().y - view.getCenter().y);
-	m_game->window().setView(view);
+	float window_center_x= camera_x();
+	list.view_center= sf::Vector2f(window_center_x, height() / 2.0f);
+	list.view_size= sf::Vector2f((float)width(), (float)height());
 
 	// draw all Entity textures / animations
 	if (m_draw_textures)
 	{
-		for (auto e : m_entity_manager.get_entities())
+		for (auto [e, transform, c_animation] : m_entity_manager->view<c_Transform, c_Animation>())
 		{
-			auto &transform= e->get_component<c_Transform>();
+			auto &animation= c_animation.animation;
 
-			if (e->has_component<c_Animation>())
-			{
-				auto &animation= e->get_component<c_Animation>().animation;
-				animation.get_sprite().setRotation(transform.angle);
-				animation.get_sprite().setPosition(transform.position.x, transform.position.y);
-				animation.get_sprite().setScale(transform.scale.x, transform.scale.y);
-				m_game->window().draw(animation.get_sprite());
-			}
+			// entities outside the view are skipped before their frame is even looked up
+			if (std::abs(transform.position.x - window_center_x) > width() / 2.0f + animation.get_size().x * std::abs(transform.scale.x)) { continue; }
+
+			list.sprite(e_Layer::World, animation.get_texture(), animation.get_frame_rect(animation.frame_index(m_animation_frame)),
+						sf::Vector2f(animation.get_size().x / 2.0f, animation.get_size().y / 2.0f),
+						sf::Vector2f(transform.position.x, transform.position.y),
+						sf::Vector2f(transform.scale.x, transform.scale.y), transform.angle);
 		}
+
+		m_projectiles.draw(list, window_center_x - width() / 2.0f, window_center_x + width() / 2.0f);
+		m_particles.draw(list, m_animation_frame, window_center_x - width() / 2.0f, window_center_x + width() / 2.0f);
 	}
 
-	// draw all Entity collision bounding boxes with a rectangle shape
+	// draw all Entity collision bounding boxes as outlines, merged tiles as their colliders
 	if (m_draw_collision)
 	{
-		for (auto e : m_entity_manager.get_entities())
+		for (auto &c : m_tile_colliders.colliders())
 		{
-			if (e->has_component<c_Bounding_box>())
-			{
-				auto &box= e->get_component<c_Bounding_box>();
-				auto &transform= e->get_component<c_Transform>();
-				sf::RectangleShape rectangle;
-				rectangle.setSize(sf::Vector2f(box.size.x - 1, box.size.y - 1));
-				rectangle.setOrigin(sf::Vector2f(box.half_size.x, box.half_size.y));
-				rectangle.setPosition(transform.position.x, transform.position.y);
-				rectangle.setFillColor(sf::Color(0, 0, 0, 0));
-				rectangle.setOutlineColor(sf::Color(255, 255, 255, 255));
-				rectangle.setOutlineThickness(1);
-				m_game->window().draw(rectangle);
-			}
+			list.rect(e_Layer::Debug, sf::Vector2f(c.position.x, c.position.y), sf::Vector2f(c.half_size.x * 2, c.half_size.y * 2));
 		}
-	}
 
-	// draw the grid so that students can easily debug
-	if (m_draw_grid)
-	{
-		float left_x= m_game->window().getView().getCenter().x - width() / 2;
-		float right_x= left_x + width() + m_grid_size.x;
-		float next_grid_x= left_x - ((int)left_x % (int)m_grid_size.x);
-
-		for (float x= next_grid_x; x < right_x; x+= m_grid_size.x)
+		for (auto [e, transform, box] : m_entity_manager->view<c_Transform, c_Bounding_box>())
 		{
-			draw_line(c_Vec2(x, 0), c_Vec2(x, height()));
+			list.rect(e_Layer::Debug, sf::Vector2f(transform.position.x, transform.position.y), sf::Vector2f(box.size.x, box.size.y));
 		}
+	}
 
-		for (float y= 0; y < height(); y+= m_grid_size.y)
-		{
-			draw_line(c_Vec2(left_x, height() - y), c_Vec2(right_x, height() - y));
+	// draw the grid so that students can easily debug, it is one command for the columns
+	// in view that the backend builds once and keeps until a new column scrolls in
+	if (m_draw_grid)
+	{
+		float left_x= window_center_x - width() / 2;
+		int first_column= (int)std::floor(left_x / m_grid_size.x);
+		int last_column= (int)std::floor((left_x + width()) / m_grid_size.x);
 
-			for (float x= next_grid_x; x < right_x; x+= m_grid_size.x)
-			{
-				std::string x_cell= std::to_string((int)x / (int)m_grid_size.x);
-				std::string y_cell= std::to_string((int)y / (int)m_grid_size.y);
-				m_grid_text.setString("( " + x_cell + " , " + y_cell + " )");
-				m_grid_text.setPosition(x + 3, height() - y - m_grid_size.y + 2);
-				m_game->window().draw(m_grid_text);
-			}
-		}
+		list.grid(e_Layer::Debug, e_Font::Arial, m_grid_character_size, sf::Vector2f(m_grid_size.x, m_grid_size.y), (float)height(),
+				  first_column, last_column - first_column + 1, (int)std::ceil(height() / m_grid_size.y));
 	}
-}
\ No newline at end of file
+}
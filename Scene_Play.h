@@ -6,18 +6,53 @@
 #include <memory>
 
 #include "Entity_Manager.h"
+#include "Prefab.h"
+#include "Events.h"
+#include "Snapshot.h"
+#include "Particle_System.h"
+#include "Projectile_System.h"
+#include "Nav_Graph.h"
+#include "Tile_Colliders.h"
+#include "Timer_Wheel.h"
+#include "Render_List.h"
 
 class Scene_Play : public Scene
 {
 	struct player_config
 	{
 		float X, Y, CX, CY, SPEED, MAXSPEED, JUMP, GRAVITY;
-		std::string WEAPON;
+		e_Animation WEAPON= e_Animation::Buster;		// what a shot looks like
+		e_Weapon	WEAPON_MODE= e_Weapon::Buster;		// how it fires
 	};
 
-	struct goomba_config
+	struct pathing_config
 	{
-		float CX, CY, SPEED, MAXSPEED, GRAVITY;
+		float SPEED= 0, JUMP= 0;
+	};
+
+	enum class e_Record_Type	{ Tile, Dec, Enemy };
+	enum class e_Record_State	{ Intact, Spent, Destroyed };
+
+	// one parsed line of the level file, kept for the whole scene so chunks
+	// can be spawned and despawned without losing what happened to them
+	struct level_record
+	{
+		e_Record_Type		type= e_Record_Type::Tile;
+		const Animation	   *animation= nullptr;
+		int					prefab= -1;		// what an enemy is spawned from
+		c_Vec2				grid_pos;
+		e_Record_State		state= e_Record_State::Intact;
+		bool				live= false;
+	};
+
+	// the parsed level file, all of it in the level arena
+	struct level_index
+	{
+		std::pmr::vector<level_record>				records;
+		std::pmr::vector<std::pmr::vector<size_t>>	chunks;		// record indices bucketed by grid X
+		std::pmr::vector<size_t>					flags;		// the flag tops, passing one ends the level
+
+		level_index(std::pmr::memory_resource *arena) : records(arena), chunks(arena), flags(arena) {}
 	};
 
 protected:
@@ -25,40 +60,111 @@ protected:
 	std::shared_ptr<Entity> m_player;
 	std::string				m_level_path;
 	player_config			m_player_config;
-	goomba_config			m_goomba_config;
+	Prefab_Library			m_prefabs;
+	int						m_player_prefab= -1;
+	int						m_goomba_prefab= -1;		// what the level's Goomba line tunes, and the enemy for a bare animation name
+	int						m_hunter_prefab= -1;
+	pathing_config			m_pathing_config;
+	size_t					m_animation_frame= 0;		// advances once per unpaused frame, drives every animation
 	bool					m_draw_textures= true;
 	bool					m_draw_collision= false;
 	bool					m_draw_grid= false;
 	const c_Vec2			m_grid_size= { 64, 64 };
-	sf::Text				m_grid_text;
+	const unsigned			m_grid_character_size= 12;
+	Event_Bus				m_events;
+	Particle_System			m_particles{ *m_assets };
+	Projectile_System		m_projectiles;
+	size_t					m_next_shot= 0;				// the frame a held weapon fires again
+
+	std::optional<level_index>			m_level{ std::in_place, &m_arena };
+	bool								m_streaming= false;
+	int									m_chunk_width= 16;	// chunk width in grid cells
+	int									m_first_chunk= 0;
+	int									m_last_chunk= -1;
+	float								m_wake_distance= 2;	// grid cells outside the view at which enemies wake
+
+	Rewind_Buffer						m_rewind{ 0, 0 };	// only recorded when there is a window to rewind in
+	Snapshot_Bytes						m_snapshot;
+	bool								m_rewinding= false;
+	bool								m_restarting= false;
+
+	Nav_Graph							m_nav_graph;
+	Flow_Field							m_flow_field;		// toward the player, shared by every hunter
+	bool								m_nav_dirty= false;	// the tiles changed since the graph was built
+
+	Tile_Colliders						m_tile_colliders;	// the level's one cell tiles, merged
+
+	Timer_Wheel							m_lifespan_timers;	// lifespans running out, on m_current_frame
+	Timer_Wheel							m_animation_timers;	// one-shot animations ending, on m_animation_frame
 
 	void initialize(const std::string &level_path);
 
 	void load_level(const std::string &filename);
+	void restart();
 
 	virtual void on_end();
 
 	void spawn_player();
-	void spawn_bullet(std::shared_ptr<Entity> entity);
-	void spawn_coin(std::shared_ptr<Entity> question);
-	void spawn_enemy(std::string enemy_type, c_Vec2 grid_pos);
+	void fire_weapon();
+	void spawn_coin(Entity &question);
+	void spawn_enemies(const size_t *indices, size_t count);
+	void place(Entity &entity, const c_Vec2 &grid_pos);
 
-	c_Vec2 grid_to_mid_pixel(float gridX, float gridY, std::shared_ptr<Entity> entity);
+	void spawn_records(const std::pmr::vector<size_t> &indices);
+	void spawn_record(size_t index);
+	bool spawnable(const level_record &record) const;
+	void despawn(std::shared_ptr<Entity> entity);
+	void set_record_state(Entity &entity, e_Record_State state);
+	void explode_brick(Entity &tile);
+	void build_nav_graph();
+	bool merges(const level_record &record) const;
+	void build_tile_colliders();
+	void schedule_timers(const std::shared_ptr<Entity> &entity);
+	void play_once(Entity &entity, e_Animation animation);
 
+	c_Vec2 grid_to_mid_pixel(float gridX, float gridY, const Entity &entity);
+	float  camera_x();
+
+	void			s_snapshot();
+	void			s_rewind();
+	void			s_streaming();
+	void			s_activation();
+	void			s_pathing();
 	void			s_movement();
 	void			s_lifespan();
 	void			s_animation();
-	virtual void	s_do_action(const Action &action);
+	void			s_particles();
+	void			s_projectiles();
 	void			s_collision();
-	virtual void	s_render();
+	void			s_tile_events();
+	void			s_combat_events();
+	void			s_level_events();
 	void			s_enemy_spawner();
 	void			s_debug();
 
-	void draw_line(const c_Vec2 &p1, const c_Vec2 &p2);
+	void a_toggle_texture(const Action &action);
+	void a_toggle_collision(const Action &action);
+	void a_toggle_grid(const Action &action);
+	void a_pause(const Action &action);
+	void a_rewind(const Action &action);
+	void a_quit(const Action &action);
+	void a_right(const Action &action);
+	void a_left(const Action &action);
+	void a_jump(const Action &action);
+	void a_shoot(const Action &action);
 
 public:
 
-	Scene_Play(Game_Engine *game_engine, const std::string &level_path);
+	Scene_Play(Game_Engine *game_engine, const std::string &level_path, size_t width, size_t height);
+	Scene_Play(const Assets &assets, const Prefab_Library &prefabs, const std::string &level_path, size_t width, size_t height);
+
+	static Scene_Builder builder(Game_Engine *game_engine, const std::string &level_path);
 
 	virtual void update();
+
+	// called by update() with the engine's list, a headless scene only renders when asked
+	virtual void s_render(Render_List &list);
+
+	void save_snapshot(Snapshot_Bytes &bytes);
+	void load_snapshot(const Snapshot_Bytes &bytes);
 };
\ No newline at end of file
@@ -0,0 +1,425 @@
+#include "Snapshot.h"
+#include "Entity_Manager.h"
+#include "Assets.h"
+
+void Snapshot::Writer::patch_u32(size_t offset, uint32_t value)
+{
+	std::memcpy(&m_bytes[offset], &value, sizeof(value));
+}
+
+// writes every component slot whether or not the entity has it, absent components
+// are zeroed, so the record is always RECORD_SIZE bytes
+void Snapshot::Writer::write_entity(const Entity &entity)
+{
+	size_t start= m_bytes.size();
+
+	uint16_t mask= 0;
+	if (entity.has_component<c_Transform>())	{ mask|= 1 << 0; }
+	if (entity.has_component<c_Lifespan>())		{ mask|= 1 << 1; }
+	if (entity.has_component<c_Input>())		{ mask|= 1 << 2; }
+	if (entity.has_component<c_Bounding_box>())	{ mask|= 1 << 3; }
+	if (entity.has_component<c_Animation>())	{ mask|= 1 << 4; }
+	if (entity.has_component<c_Gravity>())		{ mask|= 1 << 5; }
+	if (entity.has_component<c_State>())		{ mask|= 1 << 6; }
+	if (entity.has_component<c_Streamed>())		{ mask|= 1 << 7; }
+	if (entity.has_component<c_Pathing>())		{ mask|= 1 << 8; }
+
+	write<uint32_t>((uint32_t)entity.id());
+	write<uint8_t>((uint8_t)entity.tag());
+	write<uint8_t>(entity.is_asleep() ? 1 : 0);
+	write<uint16_t>(mask);
+
+	auto &transform= entity.get_component<c_Transform>();
+	write(transform.position);
+	write(transform.previous_position);
+	write(transform.scale);
+	write(transform.velocity);
+	write(transform.angle);
+
+	auto &lifespan= entity.get_component<c_Lifespan>();
+	write<int32_t>(lifespan.lifespan);
+	write<int32_t>(lifespan.frame_created);
+
+	auto &input= entity.get_component<c_Input>();
+	write<uint8_t>(input.up | input.down << 1 | input.left << 2 | input.right << 3
+				   | input.shoot << 4 | input.can_shoot << 5 | input.can_jump << 6);
+
+	write(entity.get_component<c_Bounding_box>().size);
+
+	auto &animation= entity.get_component<c_Animation>();
+	write<uint16_t>((uint16_t)animation.animation.get_id());
+	write<uint8_t>(animation.repeat ? 1 : 0);
+	write<uint64_t>(animation.animation.start_frame());
+
+	write(entity.get_component<c_Gravity>().gravity);
+
+	auto &state= entity.get_component<c_State>();
+	write<uint8_t>((uint8_t)state.state);
+
+	auto &streamed= entity.get_component<c_Streamed>();
+	write<uint32_t>((uint32_t)streamed.record);
+	write<int32_t>(streamed.chunk);
+
+	write<int32_t>(entity.get_component<c_Pathing>().target);
+
+	assert(m_bytes.size() - start == RECORD_SIZE);
+}
+
+// recreates an entity from its record with the same id, sleep state and components
+std::shared_ptr<Entity> Snapshot::Reader::read_entity(Entity_Manager &entity_manager, const Assets &assets)
+{
+	uint32_t id=	read<uint32_t>();
+	e_Tag	 tag=	(e_Tag)read<uint8_t>();
+	bool	 asleep= read<uint8_t>() != 0;
+	uint16_t mask=	read<uint16_t>();
+
+	auto entity= entity_manager.restore_entity(id, tag, asleep);
+
+	c_Transform transform;
+	transform.position=			 read_vec2();
+	transform.previous_position= read_vec2();
+	transform.scale=			 read_vec2();
+	transform.velocity=			 read_vec2();
+	transform.angle=			 read<float>();
+	if (mask & 1 << 0) { entity->add_component<c_Transform>(transform); }
+
+	int32_t lifespan= read<int32_t>();
+	int32_t frame_created= read<int32_t>();
+	if (mask & 1 << 1) { entity->add_component<c_Lifespan>(lifespan, frame_created); }
+
+	uint8_t bits= read<uint8_t>();
+	if (mask & 1 << 2)
+	{
+		auto &input= entity->add_component<c_Input>();
+		input.up=		 bits & 1 << 0;
+		input.down=		 bits & 1 << 1;
+		input.left=		 bits & 1 << 2;
+		input.right=	 bits & 1 << 3;
+		input.shoot=	 bits & 1 << 4;
+		input.can_shoot= bits & 1 << 5;
+		input.can_jump=	 bits & 1 << 6;
+	}
+
+	c_Vec2 box_size= read_vec2();
+	if (mask & 1 << 3) { entity->add_component<c_Bounding_box>(box_size); }
+
+	e_Animation animation= (e_Animation)read<uint16_t>();
+	bool repeat= read<uint8_t>() != 0;
+	uint64_t start_frame= read<uint64_t>();
+	if (mask & 1 << 4) { entity->add_component<c_Animation>(assets.get_animation(animation), repeat, start_frame); }
+
+	float gravity= read<float>();
+	if (mask & 1 << 5) { entity->add_component<c_Gravity>(gravity); }
+
+	e_State state= (e_State)read<uint8_t>();
+	if (mask & 1 << 6) { entity->add_component<c_State>(state); }
+
+	uint32_t record= read<uint32_t>();
+	int32_t chunk= read<int32_t>();
+	if (mask & 1 << 7) { entity->add_component<c_Streamed>(record, chunk); }
+
+	int32_t target= read<int32_t>();
+	if (mask & 1 << 8) { entity->add_component<c_Pathing>(target); }
+
+	return entity;
+}
+
+namespace
+{
+	void append_u32(Snapshot_Bytes &bytes, uint32_t value)
+	{
+		size_t offset= bytes.size();
+		bytes.resize(offset + sizeof(value));
+		std::memcpy(&bytes[offset], &value, sizeof(value));
+	}
+
+	uint32_t read_u32(const uint8_t *bytes)
+	{
+		uint32_t value;
+		std::memcpy(&value, bytes, sizeof(value));
+		return value;
+	}
+
+	// run length encodes a XOR b as (zero run, literal count, literals) pairs
+	void encode_xor(const uint8_t *a, const uint8_t *b, size_t size, Snapshot_Bytes &out)
+	{
+		size_t i= 0;
+		while (i < size)
+		{
+			size_t zeros= 0;
+			while (i + zeros < size && zeros < 255 && a[i + zeros] == b[i + zeros]) { zeros++; }
+			i+= zeros;
+
+			size_t literals= 0;
+			while (i + literals < size && literals < 255 && a[i + literals] != b[i + literals]) { literals++; }
+
+			out.push_back((uint8_t)zeros);
+			out.push_back((uint8_t)literals);
+			for (size_t k= 0; k < literals; k++)
+			{
+				out.push_back(a[i + k] ^ b[i + k]);
+			}
+			i+= literals;
+		}
+	}
+
+	// applies an encode_xor stream to a copy of base, returns the bytes read from the stream
+	size_t decode_xor(const uint8_t *stream, const uint8_t *base, size_t size, uint8_t *out)
+	{
+		std::memcpy(out, base, size);
+
+		size_t read= 0;
+		size_t i= 0;
+		while (i < size)
+		{
+			size_t zeros= stream[read++];
+			size_t literals= stream[read++];
+			i+= zeros;
+			for (size_t k= 0; k < literals; k++)
+			{
+				out[i + k]^= stream[read++];
+			}
+			i+= literals;
+		}
+		return read;
+	}
+
+	struct snapshot_layout
+	{
+		size_t			header_size;
+		size_t			count;
+		const uint8_t  *header;
+		const uint8_t  *records;
+
+		snapshot_layout(const Snapshot_Bytes &bytes)
+		{
+			header_size= read_u32(&bytes[0]);
+			count=		 read_u32(&bytes[8]);
+			header=		 &bytes[Snapshot::PREFIX_SIZE];
+			records=	 header + header_size;
+		}
+
+		uint32_t id(size_t index) const { return read_u32(records + index * Snapshot::RECORD_SIZE); }
+		const uint8_t *record(size_t index) const { return records + index * Snapshot::RECORD_SIZE; }
+	};
+
+	const uint8_t OP_SAME=		'S';	// a run of records identical to the newer snapshot
+	const uint8_t OP_DIFF=		'D';	// a record that differs from its newer counterpart
+	const uint8_t OP_LITERAL=	'L';	// a record that no longer exists in the newer snapshot
+}
+
+Rewind_Buffer::Rewind_Buffer(size_t frames, size_t bytes)
+	: m_ring(bytes), m_records(frames) {}
+
+// makes room for snapshots up to this size, the scratch buffer also holds undo
+// records which can be somewhat larger than the snapshot they undo
+void Rewind_Buffer::reserve(size_t snapshot_bytes)
+{
+	m_current.reserve(2 * snapshot_bytes);
+	m_scratch.reserve(2 * snapshot_bytes);
+}
+
+// encodes what turns the newer snapshot back into the older one. Records are in
+// ascending id order in both, so they are matched up with a single merge pass
+void Rewind_Buffer::encode_undo(const Snapshot_Bytes &newer, const Snapshot_Bytes &older, Snapshot_Bytes &undo)
+{
+	snapshot_layout n(newer);
+	snapshot_layout o(older);
+
+	undo.clear();
+	append_u32(undo, (uint32_t)o.header_size);
+	append_u32(undo, (uint32_t)o.count);
+
+	if (o.header_size == n.header_size)
+	{
+		undo.push_back(1);
+		encode_xor(o.header, n.header, o.header_size, undo);
+	}
+	else
+	{
+		undo.push_back(0);
+		undo.insert(undo.end(), o.header, o.header + o.header_size);
+	}
+
+	size_t run_start= 0;
+	size_t run_count= 0;
+	auto flush_run= [&]()
+	{
+		if (run_count == 0) { return; }
+		undo.push_back(OP_SAME);
+		append_u32(undo, (uint32_t)run_start);
+		append_u32(undo, (uint32_t)run_count);
+		run_count= 0;
+	};
+
+	size_t j= 0;
+	for (size_t i= 0; i < o.count; i++)
+	{
+		uint32_t id= o.id(i);
+		while (j < n.count && n.id(j) < id) { j++; }
+
+		if (j < n.count && n.id(j) == id)
+		{
+			if (std::memcmp(o.record(i), n.record(j), Snapshot::RECORD_SIZE) == 0)
+			{
+				if (run_count > 0 && run_start + run_count == j)
+				{
+					run_count++;
+				}
+				else
+				{
+					flush_run();
+					run_start= j;
+					run_count= 1;
+				}
+			}
+			else
+			{
+				flush_run();
+				undo.push_back(OP_DIFF);
+				append_u32(undo, (uint32_t)j);
+				encode_xor(o.record(i), n.record(j), Snapshot::RECORD_SIZE, undo);
+			}
+			j++;
+		}
+		else
+		{
+			flush_run();
+			undo.push_back(OP_LITERAL);
+			undo.insert(undo.end(), o.record(i), o.record(i) + Snapshot::RECORD_SIZE);
+		}
+	}
+	flush_run();
+}
+
+void Rewind_Buffer::decode_undo(const Snapshot_Bytes &newer, const uint8_t *undo, Snapshot_Bytes &older)
+{
+	snapshot_layout n(newer);
+
+	size_t read= 0;
+	uint32_t header_size= read_u32(&undo[read]); read+= 4;
+	uint32_t count= read_u32(&undo[read]); read+= 4;
+
+	older.resize(Snapshot::PREFIX_SIZE + header_size + count * Snapshot::RECORD_SIZE);
+	std::memcpy(&older[0], &header_size, 4);
+	uint32_t record_size= (uint32_t)Snapshot::RECORD_SIZE;
+	std::memcpy(&older[4], &record_size, 4);
+	std::memcpy(&older[8], &count, 4);
+
+	uint8_t *header= &older[Snapshot::PREFIX_SIZE];
+	if (undo[read++] == 1)
+	{
+		read+= decode_xor(&undo[read], n.header, header_size, header);
+	}
+	else
+	{
+		std::memcpy(header, &undo[read], header_size);
+		read+= header_size;
+	}
+
+	uint8_t *records= header + header_size;
+	size_t written= 0;
+	while (written < count)
+	{
+		uint8_t op= undo[read++];
+		uint8_t *out= records + written * Snapshot::RECORD_SIZE;
+
+		if (op == OP_SAME)
+		{
+			size_t start= read_u32(&undo[read]); read+= 4;
+			size_t run= read_u32(&undo[read]); read+= 4;
+			std::memcpy(out, n.record(start), run * Snapshot::RECORD_SIZE);
+			written+= run;
+		}
+		else if (op == OP_DIFF)
+		{
+			size_t index= read_u32(&undo[read]); read+= 4;
+			read+= decode_xor(&undo[read], n.record(index), Snapshot::RECORD_SIZE, out);
+			written++;
+		}
+		else
+		{
+			std::memcpy(out, &undo[read], Snapshot::RECORD_SIZE);
+			read+= Snapshot::RECORD_SIZE;
+			written++;
+		}
+	}
+}
+
+// copies an undo record into the ring after the newest one, wrapping to the start when it
+// does not fit before the end and dropping the oldest records it would overwrite
+void Rewind_Buffer::store_undo(const Snapshot_Bytes &undo)
+{
+	if (m_records.empty() || undo.size() > m_ring.size())
+	{
+		clear();
+		return;
+	}
+
+	if (m_write + undo.size() > m_ring.size())
+	{
+		m_write= 0;
+	}
+
+	// records sit in the ring in the order they were written, so the ones in the
+	// way are always the oldest
+	while (m_count > 0)
+	{
+		const undo_record &oldest= m_records[m_oldest];
+		bool overlaps= oldest.offset < m_write + undo.size() && m_write < oldest.offset + oldest.size;
+
+		if (!overlaps && m_count < m_records.size()) { break; }
+
+		m_oldest= (m_oldest + 1) % m_records.size();
+		m_count--;
+	}
+
+	std::memcpy(&m_ring[m_write], undo.data(), undo.size());
+	m_records[(m_oldest + m_count) % m_records.size()]= { m_write, undo.size() };
+	m_count++;
+	m_write+= undo.size();
+}
+
+// makes the snapshot the newest one, keeping an undo record back to the previous one
+void Rewind_Buffer::push(const Snapshot_Bytes &snapshot)
+{
+	if (!m_current.empty())
+	{
+		encode_undo(snapshot, m_current, m_scratch);
+		store_undo(m_scratch);
+	}
+	m_current= snapshot;
+}
+
+// steps back one frame, returns false once there is nothing older left
+bool Rewind_Buffer::pop(Snapshot_Bytes &snapshot)
+{
+	if (m_count == 0) { return false; }
+
+	const undo_record &newest= m_records[(m_oldest + m_count - 1) % m_records.size()];
+	m_count--;
+	m_write= newest.offset;
+
+	decode_undo(m_current, &m_ring[newest.offset], m_scratch);
+	std::swap(m_current, m_scratch);
+	snapshot= m_current;
+	return true;
+}
+
+void Rewind_Buffer::clear()
+{
+	m_oldest= 0;
+	m_count= 0;
+	m_write= 0;
+	m_current.clear();
+}
+
+size_t Rewind_Buffer::size() const
+{
+	return m_count;
+}
+
+size_t Rewind_Buffer::memory() const
+{
+	return m_ring.size() + m_records.size() * sizeof(undo_record) + m_current.capacity() + m_scratch.capacity();
+}
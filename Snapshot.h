@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Common.h"
+#include "Entity.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+class Entity_Manager;
+class Assets;
+
+typedef std::vector<uint8_t> Snapshot_Bytes;
+
+// A snapshot is one contiguous buffer laid out as
+//	  u32 header size, u32 entity record size, u32 entity count
+//	  the scene header (frame, configs, level record states)
+//	  one fixed size record per entity, in ascending id order
+// Fixed size records let the rewind buffer diff two snapshots entity by entity
+namespace Snapshot
+{
+	const size_t PREFIX_SIZE=	3 * sizeof(uint32_t);
+	const size_t RECORD_SIZE=	4 + 1 + 1 + 2			// id, tag, asleep, component mask
+							  + 9 * sizeof(float)		// c_Transform
+							  + 2 * sizeof(int32_t)		// c_Lifespan
+							  + 1						// c_Input
+							  + 2 * sizeof(float)		// c_Bounding_box
+							  + 2 + 1 + 8				// c_Animation
+							  + sizeof(float)			// c_Gravity
+							  + 1						// c_State
+							  + 4 + 4					// c_Streamed
+							  + 4;						// c_Pathing
+
+	class Writer
+	{
+		Snapshot_Bytes &m_bytes;
+
+	public:
+
+		Writer(Snapshot_Bytes &bytes) : m_bytes(bytes) {}
+
+		template <typename T>
+		void write(const T &value)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "snapshots only store plain values");
+			size_t offset= m_bytes.size();
+			m_bytes.resize(offset + sizeof(T));
+			std::memcpy(&m_bytes[offset], &value, sizeof(T));
+		}
+
+		void write(const c_Vec2 &value) { write(value.x); write(value.y); }
+		void write_entity(const Entity &entity);
+		size_t size() const { return m_bytes.size(); }
+		void patch_u32(size_t offset, uint32_t value);
+	};
+
+	class Reader
+	{
+		const Snapshot_Bytes   &m_bytes;
+		size_t					m_offset= 0;
+
+	public:
+
+		Reader(const Snapshot_Bytes &bytes) : m_bytes(bytes) {}
+
+		template <typename T>
+		T read()
+		{
+			T value;
+			std::memcpy(&value, &m_bytes[m_offset], sizeof(T));
+			m_offset+= sizeof(T);
+			return value;
+		}
+
+		c_Vec2		read_vec2() { float x= read<float>(); return c_Vec2(x, read<float>()); }
+		std::shared_ptr<Entity> read_entity(Entity_Manager &entity_manager, const Assets &assets);
+	};
+}
+
+// Keeps the newest snapshot in full plus undo records, each of which turns a snapshot
+// back into the one recorded the frame before. Undo records are entity by entity
+// differences packed into one fixed size byte ring, so recording never allocates once
+// reserved and the oldest frames are dropped when either the frame or byte budget runs out
+class Rewind_Buffer
+{
+	struct undo_record
+	{
+		size_t offset= 0;
+		size_t size=   0;
+	};
+
+	Snapshot_Bytes				m_ring;
+	std::vector<undo_record>	m_records;
+	size_t						m_oldest= 0;
+	size_t						m_count=  0;
+	size_t						m_write=  0;	// ring offset the next undo record is written at
+	Snapshot_Bytes				m_current;
+	Snapshot_Bytes				m_scratch;
+
+	void encode_undo(const Snapshot_Bytes &newer, const Snapshot_Bytes &older, Snapshot_Bytes &undo);
+	void decode_undo(const Snapshot_Bytes &newer, const uint8_t *undo, Snapshot_Bytes &older);
+	void store_undo(const Snapshot_Bytes &undo);
+
+public:
+
+	Rewind_Buffer(size_t frames, size_t bytes);
+
+	void reserve(size_t snapshot_bytes);
+	void push(const Snapshot_Bytes &snapshot);
+	bool pop(Snapshot_Bytes &snapshot);
+	void clear();
+
+	size_t size() const;
+	size_t memory() const;
+};
\ No newline at end of file
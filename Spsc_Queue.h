@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Fixed capacity queue for exactly one producer thread and one consumer thread.
+// Neither side ever locks or allocates, a push onto a full queue is dropped and counted
+template <typename T, size_t N>
+class Spsc_Queue
+{
+	static_assert((N & (N - 1)) == 0, "the capacity must be a power of two");
+
+	std::array<T, N>				m_items;
+	alignas(64) std::atomic<size_t> m_head{ 0 };	// next slot to read, only the consumer moves it
+	alignas(64) std::atomic<size_t> m_tail{ 0 };	// next slot to write, only the producer moves it
+	std::atomic<size_t>				m_dropped{ 0 };
+
+public:
+
+	bool push(const T &item)
+	{
+		size_t tail= m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) == N)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_items[tail & (N - 1)]= item;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T &item)
+	{
+		size_t head= m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item= m_items[head & (N - 1)];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,75 @@
+#include "Thread_Pool.h"
+
+#include <algorithm>
+
+Thread_Pool::Thread_Pool(size_t threads)
+{
+	// hardware_concurrency() is allowed to report 0 when it does not know
+	threads= std::max<size_t>(threads, 1);
+
+	m_threads.reserve(threads);
+	for (size_t i= 0; i < threads; i++)
+	{
+		m_threads.emplace_back(&Thread_Pool::worker, this);
+	}
+}
+
+Thread_Pool::~Thread_Pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping= true;
+	}
+	m_work_ready.notify_all();
+
+	for (auto &thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void Thread_Pool::worker()
+{
+	size_t batch= 0;
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_work_ready.wait(lock, [&]() { return m_stopping || m_batch != batch; });
+
+		if (m_stopping) { return; }
+		batch= m_batch;
+		lock.unlock();
+
+		for (size_t i= m_next_job++; i < m_job_count; i= m_next_job++)
+		{
+			m_job(i);
+		}
+
+		lock.lock();
+		if (--m_busy_workers == 0)
+		{
+			m_work_done.notify_one();
+		}
+	}
+}
+
+size_t Thread_Pool::size() const
+{
+	return m_threads.size();
+}
+
+// calls job(i) for every i below count across the workers, returns once all are done
+void Thread_Pool::parallel_for(size_t count, const std::function<void(size_t)> &job)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_job= job;
+	m_job_count= count;
+	m_next_job= 0;
+	m_busy_workers= m_threads.size();
+	m_batch++;
+	m_work_ready.notify_all();
+
+	m_work_done.wait(lock, [&]() { return m_busy_workers == 0; });
+	m_job= nullptr;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// A fixed set of worker threads that run one batch of jobs at a time. Jobs are
+// handed out through an atomic index, so uneven jobs balance themselves
+class Thread_Pool
+{
+	std::vector<std::thread>	m_threads;
+	std::mutex					m_mutex;
+	std::condition_variable		m_work_ready;
+	std::condition_variable		m_work_done;
+	std::function<void(size_t)> m_job;
+	size_t						m_job_count= 0;
+	std::atomic<size_t>			m_next_job{ 0 };
+	size_t						m_busy_workers= 0;
+	size_t						m_batch= 0;
+	bool						m_stopping= false;
+
+	void worker();
+
+public:
+
+	Thread_Pool(size_t threads= std::thread::hardware_concurrency());
+	~Thread_Pool();
+
+	Thread_Pool(const Thread_Pool &)= delete;
+	Thread_Pool &operator=(const Thread_Pool &)= delete;
+
+	size_t size() const;
+	void   parallel_for(size_t count, const std::function<void(size_t)> &job);
+};
@@ -0,0 +1,151 @@
+#include "Tile_Colliders.h"
+
+// sizes the grid, a level can never have more colliders than solid cells
+void Tile_Colliders::reset(int columns, int rows, const c_Vec2 &cell_size, float bottom)
+{
+	m_columns=	 columns;
+	m_rows=		 rows;
+	m_cell_size= cell_size;
+	m_bottom=	 bottom;
+
+	size_t cells= (size_t)columns * rows;
+	m_solid.assign(cells, 0);
+	m_owner.assign(cells, -1);
+	m_tiles.assign(cells, nullptr);
+	m_colliders.clear();
+	m_colliders.reserve(cells);
+}
+
+void Tile_Colliders::clear_solid()
+{
+	std::fill(m_solid.begin(), m_solid.end(), 0);
+	std::fill(m_owner.begin(), m_owner.end(), -1);
+	m_colliders.clear();
+}
+
+void Tile_Colliders::clear_tiles()
+{
+	std::fill(m_tiles.begin(), m_tiles.end(), nullptr);
+}
+
+void Tile_Colliders::set_solid(int column, int row)
+{
+	if (in_grid(column, row)) { m_solid[cell(column, row)]= 1; }
+}
+
+bool Tile_Colliders::in_grid(int column, int row) const
+{
+	return column >= 0 && column < m_columns && row >= 0 && row < m_rows;
+}
+
+bool Tile_Colliders::is_free(int column, int row) const
+{
+	return m_solid[cell(column, row)] && m_owner[cell(column, row)] < 0;
+}
+
+// merges every solid cell into colliders
+void Tile_Colliders::build()
+{
+	std::fill(m_owner.begin(), m_owner.end(), -1);
+	m_colliders.clear();
+	merge(0, 0, m_columns - 1, m_rows - 1);
+}
+
+// covers the solid cells of a block that no collider owns yet: each one starts a
+// collider that grows right as far as the row allows, then up while the whole width fits
+void Tile_Colliders::merge(int first_column, int first_row, int last_column, int last_row)
+{
+	for (int r= first_row; r <= last_row; r++)
+	{
+		for (int c= first_column; c <= last_column; c++)
+		{
+			if (!is_free(c, r)) { continue; }
+
+			int columns= 1;
+			while (c + columns <= last_column && is_free(c + columns, r)) { columns++; }
+
+			int rows= 1;
+			while (r + rows <= last_row)
+			{
+				bool fits= true;
+				for (int i= c; i < c + columns && fits; i++) { fits= is_free(i, r + rows); }
+				if (!fits) { break; }
+				rows++;
+			}
+
+			add_collider(c, r, columns, rows);
+		}
+	}
+}
+
+void Tile_Colliders::add_collider(int column, int row, int columns, int rows)
+{
+	int index= (int)m_colliders.size();
+
+	tile_collider &collider= m_colliders.emplace_back();
+	collider.column=	column;
+	collider.row=		row;
+	collider.columns=	columns;
+	collider.rows=		rows;
+	collider.half_size= c_Vec2(columns * m_cell_size.x / 2, rows * m_cell_size.y / 2);
+	collider.position=	c_Vec2(column * m_cell_size.x + collider.half_size.x, m_bottom - row * m_cell_size.y - collider.half_size.y);
+
+	for (int r= row; r < row + rows; r++)
+	{
+		for (int c= column; c < column + columns; c++)
+		{
+			m_owner[cell(c, r)]= index;
+		}
+	}
+}
+
+// frees a collider's cells, the last collider moves into its slot
+void Tile_Colliders::remove_collider(int index)
+{
+	auto relabel= [&](const tile_collider &collider, int owner)
+	{
+		for (int r= collider.row; r < collider.row + collider.rows; r++)
+		{
+			for (int c= collider.column; c < collider.column + collider.columns; c++)
+			{
+				m_owner[cell(c, r)]= owner;
+			}
+		}
+	};
+
+	relabel(m_colliders[index], -1);
+
+	int last= (int)m_colliders.size() - 1;
+	if (index != last)
+	{
+		m_colliders[index]= m_colliders[last];
+		relabel(m_colliders[index], index);
+	}
+	m_colliders.pop_back();
+}
+
+// a cell stops being solid, its collider is replaced by ones covering the cells it had left
+void Tile_Colliders::remove(int column, int row)
+{
+	if (!in_grid(column, row)) { return; }
+
+	int index= m_owner[cell(column, row)];
+	m_solid[cell(column, row)]= 0;
+	m_tiles[cell(column, row)]= nullptr;
+
+	if (index < 0) { return; }
+
+	tile_collider collider= m_colliders[index];
+	remove_collider(index);
+	merge(collider.column, collider.row, collider.column + collider.columns - 1, collider.row + collider.rows - 1);
+}
+
+void Tile_Colliders::set_tile(int column, int row, Entity *tile)
+{
+	if (in_grid(column, row)) { m_tiles[cell(column, row)]= tile; }
+}
+
+Entity *Tile_Colliders::get_tile(int column, int row) const
+{
+	return in_grid(column, row) ? m_tiles[cell(column, row)] : nullptr;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Common.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class Entity;
+
+struct tile_collider
+{
+	c_Vec2	position;			// center in pixels
+	c_Vec2	half_size;
+	int		column=	 0;			// the block of cells it covers, rows count up from the bottom
+	int		row=	 0;
+	int		columns= 0;
+	int		rows=	 0;
+};
+
+// The static one cell tiles of a level merged into as few rectangles as a greedy pass
+// finds, so a long run of ground is one collision test instead of one per tile. Every
+// cell remembers the tile entity standing in it, a hit on a collider is traced back to
+// the tiles it touched that way. Removing a cell splits its collider by merging just
+// that collider's remaining cells again. Storage is reserved on reset so neither
+// building nor splitting ever allocates
+class Tile_Colliders
+{
+	int							m_columns= 0;
+	int							m_rows=	   0;
+	c_Vec2						m_cell_size;
+	float						m_bottom=  0;		// pixel y of the bottom edge of row 0
+	std::vector<uint8_t>		m_solid;
+	std::vector<int32_t>		m_owner;			// the collider covering each cell, -1 for none
+	std::vector<Entity *>		m_tiles;			// the live tile in each cell, null while it is despawned
+	std::vector<tile_collider>	m_colliders;
+
+	int	 cell(int column, int row) const { return row * m_columns + column; }
+	bool is_free(int column, int row) const;
+	void merge(int first_column, int first_row, int last_column, int last_row);
+	void add_collider(int column, int row, int columns, int rows);
+	void remove_collider(int index);
+
+public:
+
+	void reset(int columns, int rows, const c_Vec2 &cell_size, float bottom);
+	void clear_solid();
+	void clear_tiles();
+	void set_solid(int column, int row);
+	void build();
+	void remove(int column, int row);
+
+	void	set_tile(int column, int row, Entity *tile);
+	Entity *get_tile(int column, int row) const;
+	bool	in_grid(int column, int row) const;
+	int		columns() const { return m_columns; }
+
+	// the cells a box overlaps, as an inclusive range, touching edges do not count
+	int first_column(float left) const		{ return (int)std::floor(left / m_cell_size.x); }
+	int last_column(float right) const		{ return (int)std::ceil(right / m_cell_size.x) - 1; }
+	int first_row(float bottom) const		{ return (int)std::floor((m_bottom - bottom) / m_cell_size.y); }
+	int last_row(float top) const			{ return (int)std::ceil((m_bottom - top) / m_cell_size.y) - 1; }
+
+	const std::vector<tile_collider> &colliders() const { return m_colliders; }
+
+	// calls f with each live tile of the collider that the box overlaps
+	template <typename F>
+	void for_each_tile(const tile_collider &collider, const c_Vec2 &center, const c_Vec2 &half_size, F f) const
+	{
+		int c0= std::max(collider.column, first_column(center.x - half_size.x));
+		int c1= std::min(collider.column + collider.columns - 1, last_column(center.x + half_size.x));
+		int r0= std::max(collider.row, first_row(center.y + half_size.y));
+		int r1= std::min(collider.row + collider.rows - 1, last_row(center.y - half_size.y));
+
+		for (int r= r0; r <= r1; r++)
+		{
+			for (int c= c0; c <= c1; c++)
+			{
+				if (Entity *tile= m_tiles[cell(c, r)]) { f(*tile); }
+			}
+		}
+	}
+};
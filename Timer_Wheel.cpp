@@ -0,0 +1,126 @@
+#include "Timer_Wheel.h"
+#include "Entity.h"
+
+Timer_Wheel::Timer_Wheel()
+{
+	m_slots.fill(-1);
+}
+
+// empties the wheel and reserves room for the timers it is expected to hold at once
+void Timer_Wheel::reset(uint64_t now, size_t capacity)
+{
+	m_timers.clear();
+	m_timers.reserve(capacity);
+	m_free= -1;
+	clear(now);
+}
+
+// drops every timer, the wheel carries on from the given frame
+void Timer_Wheel::clear(uint64_t now)
+{
+	for (timer &t : m_timers)
+	{
+		t.entity.reset();
+	}
+	for (int32_t i= 0; i < (int32_t)m_timers.size(); i++)
+	{
+		m_timers[i].next= i + 1 < (int32_t)m_timers.size() ? i + 1 : -1;
+	}
+	m_free= m_timers.empty() ? -1 : 0;
+
+	m_slots.fill(-1);
+	m_overflow= -1;
+	m_count= 0;
+	m_now= now;
+}
+
+// a timer that is already due fires on the next frame advanced to
+void Timer_Wheel::schedule(uint64_t due, const std::shared_ptr<Entity> &entity)
+{
+	int32_t index;
+	if (m_free >= 0)
+	{
+		index= m_free;
+		m_free= m_timers[index].next;
+	}
+	else
+	{
+		index= (int32_t)m_timers.size();
+		m_timers.emplace_back();
+	}
+
+	m_timers[index].due= due > m_now ? due : m_now + 1;
+	m_timers[index].entity= entity;
+	m_count++;
+
+	place(index);
+}
+
+// files a timer in the finest level whose current span holds its frame
+void Timer_Wheel::place(int32_t index)
+{
+	timer &t= m_timers[index];
+
+	for (int level= 0; level < LEVELS; level++)
+	{
+		int shift= BITS * (level + 1);
+		if ((t.due >> shift) == (m_now >> shift))
+		{
+			int32_t &slot= m_slots[level * SLOTS + ((t.due >> (BITS * level)) & (SLOTS - 1))];
+			t.next= slot;
+			slot= index;
+			return;
+		}
+	}
+
+	t.next= m_overflow;
+	m_overflow= index;
+}
+
+// refiles a list of timers against the current frame
+void Timer_Wheel::cascade(int32_t &list)
+{
+	int32_t index= list;
+	list= -1;
+
+	while (index >= 0)
+	{
+		int32_t next= m_timers[index].next;
+		place(index);
+		index= next;
+	}
+}
+
+// moves on one frame and unlinks the timers due on it. Entering a new span of a level
+// first brings that span's slot down from the coarser levels, coarsest first
+int32_t Timer_Wheel::step()
+{
+	m_now++;
+
+	if ((m_now & ((uint64_t(1) << (BITS * LEVELS)) - 1)) == 0)
+	{
+		cascade(m_overflow);
+	}
+	for (int level= LEVELS - 1; level > 0; level--)
+	{
+		if ((m_now & ((uint64_t(1) << (BITS * level)) - 1)) == 0)
+		{
+			cascade(m_slots[level * SLOTS + ((m_now >> (BITS * level)) & (SLOTS - 1))]);
+		}
+	}
+
+	int32_t &slot= m_slots[m_now & (SLOTS - 1)];
+	int32_t due= slot;
+	slot= -1;
+	return due;
+}
+
+size_t Timer_Wheel::size() const
+{
+	return m_count;
+}
+
+uint64_t Timer_Wheel::now() const
+{
+	return m_now;
+}
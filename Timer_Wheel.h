@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Entity;
+
+// Entity timers keyed on a frame number, in a hierarchical wheel: four levels of 64
+// slots, each level 64 times coarser than the one below. A timer is filed in the
+// finest level whose span still holds its frame and drops a level each time the wheel
+// reaches its coarser slot, so advancing a frame only touches the timers expiring on
+// it. Timers keep their entity alive, whoever fires them checks it still wants them
+class Timer_Wheel
+{
+	static constexpr int	  BITS=	  6;
+	static constexpr int	  SLOTS=  1 << BITS;
+	static constexpr int	  LEVELS= 4;
+
+	struct timer
+	{
+		uint64_t				due= 0;
+		std::shared_ptr<Entity> entity;
+		int32_t					next= -1;
+	};
+
+	uint64_t							m_now= 0;			// the last frame advanced to
+	std::vector<timer>					m_timers;			// every timer, free ones linked through next
+	int32_t								m_free= -1;
+	std::array<int32_t, LEVELS * SLOTS> m_slots;			// the first timer in each slot
+	int32_t								m_overflow= -1;		// timers beyond the top level's span
+	size_t								m_count= 0;
+
+	void	place(int32_t index);
+	void	cascade(int32_t &list);
+	int32_t step();
+
+public:
+
+	Timer_Wheel();
+
+	void reset(uint64_t now, size_t capacity);
+	void clear(uint64_t now);
+	void schedule(uint64_t due, const std::shared_ptr<Entity> &entity);
+
+	size_t	 size() const;
+	uint64_t now()	const;
+
+	// moves the wheel on to the given frame, calling f(entity, due) for every timer that
+	// expired on the way. f may schedule more timers
+	template <typename F>
+	void advance(uint64_t now, F f)
+	{
+		while (m_now < now)
+		{
+			for (int32_t index= step(); index >= 0;)
+			{
+				uint64_t due= m_timers[index].due;
+				std::shared_ptr<Entity> entity= std::move(m_timers[index].entity);
+				int32_t next= m_timers[index].next;
+
+				m_timers[index].next= m_free;
+				m_free= index;
+				m_count--;
+
+				f(*entity, due);
+				index= next;
+			}
+		}
+	}
+};
@@ -0,0 +1,215 @@
+#include "Trace.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct event
+	{
+		const char *name;
+		int64_t		time;		// nanoseconds since the program started
+		char		phase;		// 'B'egin, 'E'nd or 'i'nstant, as the trace format spells them
+	};
+
+	// about a minute and a half of frames on the main thread, 3MB per thread that records
+	const size_t BUFFER_EVENTS= 1 << 17;
+
+	// Written only by the thread that owns it. An event is published by storing the new
+	// count with release order, stop() reads the count with acquire order and never
+	// looks past it. A buffer belongs to the capture whose generation it holds, the owner
+	// empties it the first time it records into a newer capture
+	struct thread_buffer
+	{
+		std::array<event, BUFFER_EVENTS> events;
+		std::atomic<size_t>				 count{ 0 };
+		std::atomic<size_t>				 generation{ 0 };
+		std::atomic<size_t>				 dropped{ 0 };
+		std::atomic<bool>				 in_use{ true };
+		std::atomic<const char *>		 name{ nullptr };
+		size_t							 id= 0;
+	};
+
+	std::atomic<bool>	g_capturing{ false };
+	std::atomic<size_t> g_generation{ 0 };
+	const auto			g_origin= std::chrono::steady_clock::now();
+
+	// buffers are never freed, one left by a thread that ended is handed to the next new thread
+	std::mutex									g_buffers_mutex;
+	std::vector<std::unique_ptr<thread_buffer>> g_buffers;
+
+	// gives the thread's buffer back when the thread ends
+	struct buffer_owner
+	{
+		thread_buffer *buffer= nullptr;
+
+		~buffer_owner()
+		{
+			if (buffer) { buffer->in_use= false; }
+		}
+	};
+
+	thread_local buffer_owner t_owner;
+	thread_local const char	 *t_name= nullptr;
+
+	thread_buffer *thread_buffer_for_capture()
+	{
+		thread_buffer *buffer= t_owner.buffer;
+
+		if (!buffer)
+		{
+			std::lock_guard<std::mutex> lock(g_buffers_mutex);
+
+			// a free buffer still holding events of the current capture is left alone until it is written out
+			size_t generation= g_generation.load();
+			for (auto &b : g_buffers)
+			{
+				if (!b->in_use && (b->generation != generation || b->count == 0))
+				{
+					buffer= b.get();
+					break;
+				}
+			}
+			if (!buffer)
+			{
+				g_buffers.push_back(std::make_unique<thread_buffer>());
+				buffer= g_buffers.back().get();
+				buffer->id= g_buffers.size();
+			}
+
+			buffer->in_use= true;
+			buffer->count= 0;
+			buffer->generation= 0;
+			buffer->name= t_name;
+			t_owner.buffer= buffer;
+		}
+
+		size_t generation= g_generation.load(std::memory_order_relaxed);
+		if (buffer->generation.load(std::memory_order_relaxed) != generation)
+		{
+			buffer->count.store(0, std::memory_order_relaxed);
+			buffer->dropped.store(0, std::memory_order_relaxed);
+			buffer->generation.store(generation, std::memory_order_release);
+		}
+		return buffer;
+	}
+
+	void record(const char *name, char phase)
+	{
+		int64_t time= std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_origin).count();
+		thread_buffer *buffer= thread_buffer_for_capture();
+
+		size_t count= buffer->count.load(std::memory_order_relaxed);
+		if (count == BUFFER_EVENTS)
+		{
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer->events[count]= { name, time, phase };
+		buffer->count.store(count + 1, std::memory_order_release);
+	}
+}
+
+bool Trace::capturing()
+{
+	return g_capturing.load(std::memory_order_relaxed);
+}
+
+// the calling thread's buffer is made here, so starting mid frame is the only
+// frame where recording on this thread allocates
+void Trace::start()
+{
+	g_generation++;
+	g_capturing= true;
+	thread_buffer_for_capture();
+}
+
+// stops recording and writes every buffer filled during this capture
+bool Trace::stop(const std::string &path)
+{
+	g_capturing= false;
+
+	std::ofstream file(path);
+	if (!file) { return false; }
+
+	std::lock_guard<std::mutex> lock(g_buffers_mutex);
+	size_t generation= g_generation.load();
+	bool first= true;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (auto &buffer : g_buffers)
+	{
+		if (buffer->generation.load(std::memory_order_acquire) != generation) { continue; }
+
+		size_t count= buffer->count.load(std::memory_order_acquire);
+		const char *name= buffer->name.load(std::memory_order_relaxed);
+
+		file << (first ? "\n" : ",\n");
+		file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->id
+			 << ",\"args\":{\"name\":\"" << (name ? name : "thread") << "\"}}";
+		first= false;
+
+		for (size_t i= 0; i < count; i++)
+		{
+			const event &e= buffer->events[i];
+			file << ",\n{\"ph\":\"" << e.phase << "\",\"name\":\"" << e.name << "\",\"pid\":1,\"tid\":" << buffer->id
+				 << ",\"ts\":" << e.time / 1000 << "." << (char)('0' + e.time / 100 % 10) << (char)('0' + e.time / 10 % 10) << (char)('0' + e.time % 10);
+			if (e.phase == 'i') { file << ",\"s\":\"g\""; }
+			file << "}";
+		}
+	}
+	file << "\n]}\n";
+
+	return file.good();
+}
+
+size_t Trace::dropped()
+{
+	std::lock_guard<std::mutex> lock(g_buffers_mutex);
+
+	size_t dropped= 0;
+	for (auto &buffer : g_buffers)
+	{
+		if (buffer->generation == g_generation) { dropped+= buffer->dropped; }
+	}
+	return dropped;
+}
+
+void Trace::name_thread(const char *name)
+{
+	t_name= name;
+	if (t_owner.buffer) { t_owner.buffer->name= name; }
+}
+
+void Trace::begin(const char *name)
+{
+	if (capturing()) { record(name, 'B'); }
+}
+
+void Trace::end(const char *name)
+{
+	if (capturing()) { record(name, 'E'); }
+}
+
+// a point in time rather than a span, drawn across every thread
+void Trace::instant(const char *name)
+{
+	if (capturing()) { record(name, 'i'); }
+}
+
+Trace::Scope::Scope(const char *name)
+	: m_name(name), m_active(capturing())
+{
+	if (m_active) { record(name, 'B'); }
+}
+
+Trace::Scope::~Scope()
+{
+	if (m_active) { record(m_name, 'E'); }
+}
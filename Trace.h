@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Records the start and end of named spans into a fixed size buffer per thread and writes
+// them out as Chrome trace event JSON, which chrome://tracing and ui.perfetto.dev open.
+// Only the owning thread writes to a buffer, so recording never locks, and while nothing
+// is being captured a span costs one relaxed atomic load.
+// Span names are kept by pointer, so they have to be string literals
+namespace Trace
+{
+	bool	capturing();
+	void	start();
+	bool	stop(const std::string &path);		// false when the file could not be written
+	size_t	dropped();							// events lost to full buffers in the last capture
+
+	void	name_thread(const char *name);		// the label the calling thread gets in the trace
+	void	begin(const char *name);
+	void	end(const char *name);
+	void	instant(const char *name);
+
+	// a span covering its own lifetime, ended even if capturing stops in the middle of it
+	class Scope
+	{
+		const char *m_name;
+		bool		m_active;
+
+	public:
+
+		Scope(const char *name);
+		~Scope();
+	};
+}
+
+#define TRACE_SCOPE_JOIN(a, b) a##b
+#define TRACE_SCOPE_NAME(line) TRACE_SCOPE_JOIN(trace_scope_, line)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_SCOPE_NAME(__LINE__)(name)
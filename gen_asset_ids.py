@@ -0,0 +1,92 @@
+# Generates Asset_IDs.h from assets.txt. Run before every build (the Visual Studio
+# project does this as a pre-build step), the header only changes when assets.txt does.
+#
+#   python gen_asset_ids.py [assets.txt] [Asset_IDs.h]
+
+import os
+import re
+import sys
+
+KINDS= [
+	# asset line,	enum,			names table
+	('Texture',		'e_Texture',	'TEXTURE_NAMES'),
+	('Animation',	'e_Animation',	'ANIMATION_NAMES'),
+	('Atlas',		'e_Atlas',		'ATLAS_NAMES'),
+	('Font',		'e_Font',		'FONT_NAMES'),
+	('Sound',		'e_Sound',		'SOUND_NAMES'),
+]
+
+IDENTIFIER= re.compile(r'^[A-Za-z_][A-Za-z0-9_]*$')
+
+
+def read_names(path):
+	names= { kind: [] for kind, _, _ in KINDS }
+
+	with open(path) as file:
+		for number, line in enumerate(file, 1):
+			words= line.split()
+			if not words:
+				continue
+			if words[0] not in names or len(words) < 2:
+				sys.exit('%s:%d: unknown asset line: %s' % (path, number, line.strip()))
+
+			name= words[1]
+			if not IDENTIFIER.match(name) or name == 'Count':
+				sys.exit('%s:%d: %s is not usable as an id' % (path, number, name))
+			if name in names[words[0]]:
+				sys.exit('%s:%d: %s %s is declared twice' % (path, number, words[0], name))
+			names[words[0]].append(name)
+
+	return names
+
+
+def generate(names):
+	lines= [
+		'// Generated from assets.txt by gen_asset_ids.py, do not edit.',
+		'// Every asset gets an id, so a misspelled asset name is a compile error',
+		'// and looking an asset up is an array index',
+		'#pragma once',
+		'',
+		'#include <cstddef>',
+		'#include <cstdint>',
+		'',
+	]
+
+	for kind, enum, _ in KINDS:
+		lines.append('enum class %s : uint16_t' % enum)
+		lines.append('{')
+		for name in names[kind]:
+			lines.append('\t%s,' % name)
+		lines.append('\tCount')
+		lines.append('};')
+		lines.append('')
+
+	lines.append('namespace Asset_IDs')
+	lines.append('{')
+	for kind, enum, table in KINDS:
+		quoted= ', '.join('"%s"' % name for name in names[kind])
+		lines.append('\tinline constexpr const char *%s[(size_t)%s::Count + 1]= { %s%snullptr };' % (table, enum, quoted, ', ' if quoted else ''))
+	lines.append('}')
+
+	return '\n'.join(lines) + '\n'
+
+
+def main():
+	here= os.path.dirname(os.path.abspath(__file__))
+	source= sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, 'assets.txt')
+	target= sys.argv[2] if len(sys.argv) > 2 else os.path.join(here, 'Asset_IDs.h')
+
+	header= generate(read_names(source))
+
+	# leaving an up to date header untouched keeps it from triggering a full rebuild
+	if os.path.exists(target):
+		with open(target, newline='') as file:
+			if file.read() == header:
+				return
+
+	with open(target, 'w', newline='') as file:
+		file.write(header)
+
+
+if __name__ == '__main__':
+	main()
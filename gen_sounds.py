@@ -0,0 +1,88 @@
+# Writes the game's sound effects into sounds/ as 16 bit mono wav files. They are
+# simple synthesized blips, so they are made here instead of being drawn from a
+# sound library. Only needs running again after changing one of the effects below.
+#
+#   python gen_sounds.py [directory]
+
+import math
+import os
+import random
+import struct
+import sys
+import wave
+
+RATE= 22050
+
+
+def square(phase):
+	return 1.0 if phase % 1.0 < 0.5 else -1.0
+
+
+def triangle(phase):
+	return 4.0 * abs(phase % 1.0 - 0.5) - 1.0
+
+
+# a tone gliding from one frequency to another, fading out linearly
+def sweep(seconds, start, end, wave_shape= square, volume= 0.5):
+	samples= []
+	phase= 0.0
+	count= int(seconds * RATE)
+	for i in range(count):
+		t= i / count
+		phase+= (start + (end - start) * t) / RATE
+		samples.append(wave_shape(phase) * volume * (1.0 - t))
+	return samples
+
+
+# white noise through a falling low pass, for breaking and squashing
+def noise(seconds, brightness= 0.5, volume= 0.6, seed= 1):
+	source= random.Random(seed)
+	samples= []
+	value= 0.0
+	count= int(seconds * RATE)
+	for i in range(count):
+		t= i / count
+		value+= (source.uniform(-1.0, 1.0) - value) * brightness * (1.0 - t)
+		samples.append(value * volume * (1.0 - t))
+	return samples
+
+
+def notes(*parts):
+	samples= []
+	for part in parts:
+		samples+= part
+	return samples
+
+
+SOUNDS= {
+	'jump':	 lambda: sweep(0.18, 300, 900, square, 0.3),
+	'shoot': lambda: sweep(0.08, 1400, 500, square, 0.25),
+	'bump':	 lambda: sweep(0.08, 180, 90, triangle, 0.6),
+	'brick': lambda: noise(0.3, 0.6, 0.7, 2),
+	'coin':	 lambda: notes(sweep(0.06, 988, 988, square, 0.3), sweep(0.3, 1319, 1319, square, 0.3)),
+	'stomp': lambda: notes(noise(0.05, 0.8, 0.6, 3), sweep(0.12, 400, 150, triangle, 0.6)),
+	'kill':	 lambda: notes(noise(0.08, 0.9, 0.5, 4), sweep(0.2, 600, 100, square, 0.3)),
+	'die':	 lambda: notes(sweep(0.15, 700, 700, square, 0.3), sweep(0.6, 700, 150, square, 0.3)),
+	'flag':	 lambda: notes(*[sweep(0.12, f, f, square, 0.3) for f in (523, 659, 784, 1047)]),
+}
+
+
+def write(path, samples):
+	with wave.open(path, 'wb') as file:
+		file.setnchannels(1)
+		file.setsampwidth(2)
+		file.setframerate(RATE)
+		file.writeframes(b''.join(struct.pack('<h', int(max(-1.0, min(1.0, s)) * 32767)) for s in samples))
+
+
+def main():
+	here= os.path.dirname(os.path.abspath(__file__))
+	directory= sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, 'sounds')
+	os.makedirs(directory, exist_ok= True)
+
+	for name, make in SOUNDS.items():
+		write(os.path.join(directory, name + '.wav'), make())
+
+
+if __name__ == '__main__':
+	main()